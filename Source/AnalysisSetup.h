@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    AnalysisSetup.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "WindowTable.h"
+#include "SlicedFFT.h"
+
+//==============================================================================
+/**
+	Everything that depends on the window length and the transform size. It is
+	built on the message thread and handed to the audio thread in a single
+	pointer swap, so changing either never allocates inside processBlock.
+
+	With zero padding the transform is longer than the window, the samples past
+	windowSize are zero and the extra bins interpolate the spectrum of the window.
+*/
+struct AnalysisSetup
+{
+	AnalysisSetup(int windowOrder, int transformOrder, FFTPlanCache& plans)
+		: fftOrder(transformOrder),
+		  fftSize(1 << transformOrder),
+		  windowSize(1 << windowOrder),
+		  numBins((1 << transformOrder) / 2 + 1),
+		  fft(plans.getPlan(transformOrder)),
+		  sliced(plans.getSlicedPlan(transformOrder))
+	{
+		windowTable.createWindowTable(windowSize);
+	}
+
+	const int fftOrder;
+	const int fftSize;
+	// samples taken from the ring per frame, fftSize without zero padding
+	const int windowSize;
+	// real input only has N / 2 + 1 meaningful bins, everything downstream keeps the half spectrum
+	const int numBins;
+
+	// --- shared with every setup of the same size, each pool thread transforms into its own scratch
+	std::shared_ptr<const FFTBackend> fft;
+	// --- large sizes only, the pool then splits each channel's transform into slices instead of using fft
+	std::shared_ptr<const SlicedFFT> sliced;
+	WindowTable windowTable;
+
+	JUCE_DECLARE_NON_COPYABLE(AnalysisSetup)
+};
+
+//==============================================================================
+/**
+	The setups analysed side by side over the same rings. Layer 0 uses the
+	selected window, every further layer a quarter of the previous length, so
+	the low end gets the long window and the top end the short ones. A layout
+	is handed to the audio thread as a whole, exactly like a single setup.
+*/
+struct AnalysisLayout
+{
+	static constexpr int maxNumLayers = 3;
+
+	AnalysisLayout(int windowOrder, int paddingOrder, int requestedLayers, int minWindowOrder, int maxTransformOrder, FFTPlanCache& plans)
+	{
+		numLayers = 0;
+		for (int layer = 0; layer < juce::jlimit(1, maxNumLayers, requestedLayers); layer++)
+		{
+			// --- a layer that would drop below the shortest window is left out
+			auto order = windowOrder - 2 * layer;
+			if (layer > 0 && order < minWindowOrder)
+				break;
+
+			layers[numLayers++].reset(new AnalysisSetup(order, juce::jmin(maxTransformOrder, order + paddingOrder), plans));
+		}
+	}
+
+	std::unique_ptr<AnalysisSetup> layers[maxNumLayers];
+	int numLayers;
+
+	JUCE_DECLARE_NON_COPYABLE(AnalysisLayout)
+};
@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    AnalysisThreadPool.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "AnalysisThreadPool.h"
+
+class AnalysisThreadPool::Worker : public juce::Thread
+{
+public:
+	Worker(AnalysisThreadPool& owner, int index, int maxFFTSize)
+		: juce::Thread("Spectrum FFT " + juce::String(index)),
+		  pool(owner)
+	{
+		// windowed input, 2 * N floats of transform output and the backend's work area, all aligned
+		auto numFloats = (size_t)(3 * maxFFTSize + FFTPlanCache::getMaxWorkSize(maxFFTSize));
+		storage.reset(new char[numFloats * sizeof(float) + alignment]());
+		auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+		scratch.input = reinterpret_cast<float*>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+		scratch.output = scratch.input + maxFFTSize;
+		scratch.work = scratch.output + 2 * maxFFTSize;
+	}
+
+	~Worker() override
+	{
+		stopThread(1000);
+	}
+
+	void run() override
+	{
+		while (!threadShouldExit())
+		{
+			// nobody signals the workers, so submitting a job never costs the audio thread a wake-up call
+			if (!pool.runNextTask(scratch))
+			{
+				wait(1);
+			}
+		}
+	}
+
+private:
+	static constexpr size_t alignment = 64;
+
+	AnalysisThreadPool& pool;
+	std::unique_ptr<char[]> storage;
+	Scratch scratch;
+
+	JUCE_DECLARE_NON_COPYABLE(Worker)
+};
+
+AnalysisThreadPool::AnalysisThreadPool()
+{
+	mCapacity = 0;
+	mMask = 0;
+}
+
+AnalysisThreadPool::~AnalysisThreadPool()
+{
+	releasePool();
+}
+
+void AnalysisThreadPool::createPool(int numThreads, int numJobs, int maxFFTSize)
+{
+	releasePool();
+
+	// capacity as power of 2 for the wrap mask
+	mCapacity = 1;
+	while (mCapacity < (juce::uint32)numJobs)
+		mCapacity <<= 1;
+	mMask = mCapacity - 1;
+
+	mJobs.reset(new Job[mCapacity]);
+	mSubmitIndex.store(0);
+	mRetireIndex.store(0);
+	mWritePosition.store(0);
+	mSkipped.store(0);
+	mExpired.store(0);
+
+	for (int i = 0; i < juce::jmax(1, numThreads); i++)
+	{
+		mWorkers.add(new Worker(*this, i, maxFFTSize))->startThread(juce::Thread::Priority::highest);
+	}
+}
+
+void AnalysisThreadPool::releasePool()
+{
+	for (auto* worker : mWorkers)
+		worker->signalThreadShouldExit();
+
+	mWorkers.clear();
+	mJobs.reset();
+	mSubmitIndex.store(0);
+	mRetireIndex.store(0);
+}
+
+AnalysisThreadPool::Job* AnalysisThreadPool::beginJob()
+{
+	auto submitIndex = mSubmitIndex.load(std::memory_order_relaxed);
+	if (mJobs == nullptr || submitIndex - mRetireIndex.load(std::memory_order_relaxed) >= mCapacity)
+	{
+		mSkipped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	return &mJobs[submitIndex & mMask];
+}
+
+void AnalysisThreadPool::submitJob()
+{
+	auto submitIndex = mSubmitIndex.load(std::memory_order_relaxed);
+	auto& job = mJobs[submitIndex & mMask];
+	auto numTasks = getNumTasks(job);
+
+	job.remaining.store(numTasks * getNumPasses(job), std::memory_order_relaxed);
+	job.pending.store(numTasks, std::memory_order_relaxed);
+	job.expired.store(false, std::memory_order_relaxed);
+	// the new job index in the claim word is what lets the workers touch the slot again
+	job.claim.store(((juce::uint64)submitIndex << 32) | ((juce::uint64)numTasks << 12), std::memory_order_release);
+	mSubmitIndex.store(submitIndex + 1, std::memory_order_release);
+}
+
+AnalysisThreadPool::Job* AnalysisThreadPool::getFinishedJob()
+{
+	auto retireIndex = mRetireIndex.load(std::memory_order_relaxed);
+	if (mJobs == nullptr || retireIndex == mSubmitIndex.load(std::memory_order_relaxed))
+		return nullptr;
+
+	auto& job = mJobs[retireIndex & mMask];
+	if (job.remaining.load(std::memory_order_acquire) != 0)
+		return nullptr;
+
+	return &job;
+}
+
+void AnalysisThreadPool::retireJob()
+{
+	auto retireIndex = mRetireIndex.load(std::memory_order_relaxed);
+	if (mJobs[retireIndex & mMask].expired.load(std::memory_order_relaxed))
+	{
+		mExpired.fetch_add(1, std::memory_order_relaxed);
+	}
+	mRetireIndex.store(retireIndex + 1, std::memory_order_release);
+}
+
+void AnalysisThreadPool::setWritePosition(juce::int64 position)
+{
+	// published before the samples land in the rings, a worker that read them checks this afterwards
+	mWritePosition.store(position, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+bool AnalysisThreadPool::isIdle() const
+{
+	return mRetireIndex.load(std::memory_order_relaxed) == mSubmitIndex.load(std::memory_order_relaxed);
+}
+
+int AnalysisThreadPool::getNumPasses(const Job& job)
+{
+	return job.setup->sliced != nullptr ? SlicedFFT::numPasses : 1;
+}
+
+int AnalysisThreadPool::getNumTasks(const Job& job)
+{
+	return job.setup->sliced != nullptr ? job.numSources * job.setup->sliced->getNumSlices() : job.numSources;
+}
+
+bool AnalysisThreadPool::runNextTask(Scratch& scratch)
+{
+	auto retireIndex = mRetireIndex.load(std::memory_order_acquire);
+	auto submitIndex = mSubmitIndex.load(std::memory_order_acquire);
+
+	// oldest job first, so frames finish roughly in the order the audio thread collects them
+	for (auto index = retireIndex; index != submitIndex; index++)
+	{
+		auto& job = mJobs[index & mMask];
+		auto claim = job.claim.load(std::memory_order_acquire);
+
+		// slot already reused for a later job, or every task of the current pass is taken
+		auto pass = (int)((claim >> 24) & 0xff);
+		auto numTasks = (int)((claim >> 12) & 0xfff);
+		auto task = (int)(claim & 0xfff);
+		if ((juce::uint32)(claim >> 32) != index || task >= numTasks)
+			continue;
+
+		// another thread may have taken the same task first, the caller just tries again
+		if (job.claim.compare_exchange_strong(claim, claim + 1, std::memory_order_acq_rel))
+		{
+			if (job.setup->sliced != nullptr)
+				transformSlice(job, pass, task, scratch);
+			else
+				transform(job, task, scratch);
+
+			finishTask(job, index, pass);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void AnalysisThreadPool::transform(Job& job, int source, Scratch& scratch)
+{
+	auto& setup = *job.setup;
+	auto expired = mWritePosition.load(std::memory_order_acquire) > job.deadline;
+
+	if (!expired)
+	{
+		auto& spans = job.spans[source];
+		juce::FloatVectorOperations::multiply(scratch.input, spans.data1, job.window, spans.size1);
+		if (spans.size2 > 0)
+		{
+			juce::FloatVectorOperations::multiply(scratch.input + spans.size1, spans.data2, job.window + spans.size1, spans.size2);
+		}
+
+		// only a window shorter than the last one leaves samples behind in the padding
+		if (scratch.inputLength > setup.windowSize)
+		{
+			juce::FloatVectorOperations::clear(scratch.input + setup.windowSize, scratch.inputLength - setup.windowSize);
+		}
+		scratch.inputLength = setup.windowSize;
+
+		// the rings are read without a lock, if the audio thread got past the deadline meanwhile the copy may be torn
+		std::atomic_thread_fence(std::memory_order_acquire);
+		expired = mWritePosition.load(std::memory_order_relaxed) > job.deadline;
+	}
+
+	if (!expired)
+	{
+		setup.fft->performRealForward(scratch.input, scratch.output, scratch.work);
+		memcpy(job.frame->bins.get() + source * setup.numBins, scratch.output, sizeof(std::complex<float>) * setup.numBins);
+	}
+	else
+	{
+		job.expired.store(true, std::memory_order_relaxed);
+	}
+}
+
+void AnalysisThreadPool::transformSlice(Job& job, int pass, int task, Scratch& scratch)
+{
+	auto& setup = *job.setup;
+	auto& sliced = *setup.sliced;
+	auto source = task % job.numSources;
+	auto slice = task / job.numSources;
+	auto* bins = job.frame->bins.get() + source * setup.numBins;
+	auto* work = reinterpret_cast<std::complex<float>*>(scratch.output);
+
+	// only the first pass reads the rings, the later ones work on the frame alone
+	if (pass == 0)
+	{
+		auto expired = mWritePosition.load(std::memory_order_acquire) > job.deadline;
+		if (!expired)
+		{
+			sliced.performRows(slice, job.spans[source], job.window, setup.windowSize, bins, work);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			expired = mWritePosition.load(std::memory_order_relaxed) > job.deadline;
+		}
+
+		if (expired)
+		{
+			job.expired.store(true, std::memory_order_relaxed);
+		}
+	}
+	else if (!job.expired.load(std::memory_order_relaxed))
+	{
+		if (pass == 1)
+			sliced.performColumns(slice, bins, work);
+		else
+			sliced.performSplit(slice, bins);
+	}
+}
+
+void AnalysisThreadPool::finishTask(Job& job, juce::uint32 index, int pass)
+{
+	// the last task of a pass opens the next one, the claim word carries its results to whoever takes it
+	if (job.pending.fetch_sub(1, std::memory_order_acq_rel) == 1 && pass + 1 < getNumPasses(job))
+	{
+		auto numTasks = getNumTasks(job);
+		job.pending.store(numTasks, std::memory_order_relaxed);
+		job.claim.store(((juce::uint64)index << 32) | ((juce::uint64)(pass + 1) << 24) | ((juce::uint64)numTasks << 12), std::memory_order_release);
+	}
+
+	// counts every pass, so the audio thread never sees a job finished between two of them
+	job.remaining.fetch_sub(1, std::memory_order_release);
+}
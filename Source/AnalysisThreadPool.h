@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    AnalysisThreadPool.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "CircularBuffer.h"
+#include "AnalysisSetup.h"
+#include "SpectrumFifo.h"
+
+//==============================================================================
+/**
+	Fixed set of threads that window and transform the channels of queued frames.
+
+	The audio thread fills a job with the ring spans of every channel and submits
+	it, that is all it does per frame. Each job keeps one atomic claim word, any
+	idle thread takes the next untransformed channel of the oldest job from it,
+	so a wide layout is spread over all threads and a slow thread never holds the
+	others up. Nothing in the hand-off locks, waits or allocates.
+
+	Large transforms are not taken a channel at a time but as the slices of a
+	SlicedFFT, pass by pass. Whichever thread finishes the last slice of a pass
+	publishes the next one in the claim word, so even a single channel of 65536
+	points is shared by every thread and no task grows with the transform size.
+
+	A job has a deadline in input samples. Once the audio thread has written past
+	it the rings may already hold newer audio, so the remaining channels are not
+	transformed and the frame is given up instead of delivered late or torn. When
+	every job slot is taken the audio thread skips the frame.
+*/
+class AnalysisThreadPool
+{
+public:
+	static constexpr int maxNumSources = 16;
+
+	struct Job
+	{
+		SpectrumFrame* frame = nullptr;
+		const AnalysisSetup* setup = nullptr;
+		const float* window = nullptr;
+		CircularBuffer<float>::Spans spans[maxNumSources];
+		int numSources = 0;
+		// --- last write position at which the rings still hold this frame untouched
+		juce::int64 deadline = 0;
+
+		// --- job index << 32 | pass << 24 | tasks in the pass << 12 | next task to run
+		std::atomic<juce::uint64> claim { 0 };
+		// --- tasks of every pass not finished yet, and of the current pass only
+		std::atomic<int> remaining { 0 };
+		std::atomic<int> pending { 0 };
+		std::atomic<bool> expired { false };
+	};
+
+	AnalysisThreadPool();
+	~AnalysisThreadPool();
+
+	// --- message thread, stops the threads, empties the queue and starts numThreads new ones
+	void createPool(int numThreads, int numJobs, int maxFFTSize);
+	void releasePool();
+
+	// --- audio thread, beginJob returns nullptr (and counts a skip) when every slot is taken
+	Job* beginJob();
+	void submitJob();
+	// --- audio thread, oldest job once all its channels are done, then retireJob frees it
+	Job* getFinishedJob();
+	void retireJob();
+	// --- audio thread, called before the samples up to position go into the rings
+	void setWritePosition(juce::int64 position);
+
+	bool isIdle() const;
+	juce::uint64 getSkippedCount() const { return mSkipped.load(std::memory_order_relaxed); }
+	juce::uint64 getExpiredCount() const { return mExpired.load(std::memory_order_relaxed); }
+
+private:
+	class Worker;
+
+	// --- one per thread, input past inputLength is zero so zero padding costs nothing per frame
+	struct Scratch
+	{
+		float* input = nullptr;
+		float* output = nullptr;
+		float* work = nullptr;
+		int inputLength = 0;
+	};
+
+	// --- a task is one channel, or one slice of one channel when the setup is sliced
+	static int getNumPasses(const Job& job);
+	static int getNumTasks(const Job& job);
+
+	// --- worker side, false when there was nothing to claim
+	bool runNextTask(Scratch& scratch);
+	void finishTask(Job& job, juce::uint32 index, int pass);
+	void transform(Job& job, int source, Scratch& scratch);
+	void transformSlice(Job& job, int pass, int task, Scratch& scratch);
+
+	juce::OwnedArray<Worker> mWorkers;
+	std::unique_ptr<Job[]> mJobs = nullptr;
+	juce::uint32 mCapacity;
+	juce::uint32 mMask;
+
+	// --- free running, slot = index & mMask; the audio thread moves both
+	std::atomic<juce::uint32> mSubmitIndex { 0 };
+	std::atomic<juce::uint32> mRetireIndex { 0 };
+	std::atomic<juce::int64> mWritePosition { 0 };
+
+	std::atomic<juce::uint64> mSkipped { 0 };
+	std::atomic<juce::uint64> mExpired { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(AnalysisThreadPool)
+};
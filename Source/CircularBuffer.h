@@ -9,77 +9,301 @@
 #ifndef CircularBuffer_h
 #define CircularBuffer_h
 
+#include <cstring>
+
+// --- jassert inside a juce project, the plain assert anywhere else
+#if defined(jassert)
+ #define CIRCULAR_BUFFER_ASSERT(expression) jassert(expression)
+#else
+ #include <cassert>
+ #define CIRCULAR_BUFFER_ASSERT(expression) assert(expression)
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 template <typename T>
 class CircularBuffer
 {
 
 public:
+	// --- a run of samples inside the ring, the second part is empty unless the run wraps
+	struct Spans
+	{
+		const T* data1;
+		int size1;
+		const T* data2;
+		int size2;
+	};
+
+	// --- how the storage is laid out, mirrored storage makes every window up to the buffer length contiguous
+	enum MirrorMode
+	{
+		kMirrorNone = 0,
+		// --- the same physical pages mapped twice back to back, writes show up in both halves for free
+		kMirrorMapped,
+		// --- twice the memory, every write goes to both halves
+		kMirrorCopy
+	};
+
+	// --- fractional delay interpolators, picked at compile time by the templated reads
+	enum InterpolationType
+	{
+		kInterpolateLinear = 0,
+		kInterpolateHermite,
+		// --- Order + 1 taps around the read position
+		kInterpolateLagrange,
+		// --- first order allpass, keeps state so it has to be read once per output sample in order
+		kInterpolateAllpass
+	};
+
 	CircularBuffer()
 	{
+		mData = nullptr;
+		mMapping = nullptr;
+		mMappingBytes = 0;
+		mMirrorMode = kMirrorNone;
 		mWriteIndex = 0;
 		mBufferLength = 0;
 		mWrapMask = 0;
+		mAllpassState = 0;
 	};
 
 	~CircularBuffer()
 	{
+		releaseStorage();
 	};
 
-	void createCircularBuffer(unsigned int input);
+	// --- mirrored asks for a double mapping and falls back to a mirrored copy where that is not available
+	void createCircularBuffer(unsigned int input, bool mirrored = false);
 	void flushBuffer();
 	void writeBuffer(T input);
+	void writeBuffer(const T* input, int numSamples);
 
 	T readBuffer(int delayInSamples);
 	T readBuffer(double delayInFractionalSamples, bool interpolate = true);
+	// --- numSamples in time order, the first one delayInSamples behind the write position
+	void readBuffer(T* output, int numSamples, int delayInSamples);
+	Spans getContiguousSpans(int numSamples, int delayInSamples);
+	// --- one pointer to numSamples in time order, only valid in a mirrored mode and up to the buffer length
+	const T* getContiguousBlock(int numSamples, int delayInSamples);
+
+	int getMirrorMode() const { return mMirrorMode; }
+	unsigned int getBufferLength() const { return mBufferLength; }
+
+	// --- one interpolated read, Order is only used by kInterpolateLagrange
+	template <int Interpolation, int Order = 3>
+	T readInterpolated(float delayInFractionalSamples);
+	// --- block of modulated reads for a delay line, call it after writing numSamples: output[i] is what
+	// --- readInterpolated(delaysInFractionalSamples[i]) would have returned right after sample i was written;
+	// --- on a mirrored ring hermite and lagrange gather their taps without masking and run a chunk at a time
+	template <int Interpolation, int Order = 3>
+	void readBuffer(T* output, const float* delaysInFractionalSamples, int numSamples);
 
 	float doLinearInterpolation(float delayInFractionalSamples);
 	float doHermitInterpolation(float delayInFractionalSamples);
 	float doLagrangeInterpolation(float delayInFractionalSamples);
 
 private:
+	bool createMapping();
+	void releaseStorage();
+	// --- taps[k] = readBuffer(firstDelay + k), straight from the mirror when there is one
+	void readTaps(T* taps, int firstDelay, int numTaps);
+	// --- up to maxChunkSize reads of the block, sample i of the chunk sits (age - i) behind the write position
+	template <int Interpolation, int Order>
+	void readMirroredChunk(T* output, const float* delaysInFractionalSamples, int numSamples, int age);
+
+	// --- reads per pass of readMirroredChunk, its tap and coefficient arrays live on the stack
+	static constexpr int maxChunkSize = 64;
+
+	// --- 1 / prod(i - j) over the nodes 0..Order, the part of the lagrange basis that never changes
+	template <int Order>
+	struct LagrangeWeights
+	{
+		float weight[Order + 1];
+
+		constexpr LagrangeWeights() : weight()
+		{
+			for (int i = 0; i <= Order; i++)
+			{
+				double denominator = 1.0;
+				for (int j = 0; j <= Order; j++)
+				{
+					if (j != i)
+					{
+						denominator *= (double)(i - j);
+					}
+				}
+				weight[i] = (float)(1.0 / denominator);
+			}
+		}
+	};
+
+	// --- every access goes through mData, which points either into mBuffer or into the mapping
+	T* mData;
 	std::unique_ptr<T[]> mBuffer = nullptr;
+	void* mMapping;
+	size_t mMappingBytes;
+	int mMirrorMode;
 	unsigned int mWriteIndex;
 	unsigned int mBufferLength;
 	unsigned int mWrapMask;
+	T mAllpassState;
 };
 
 template <typename T>
-void CircularBuffer<T>::createCircularBuffer(unsigned int input)
+void CircularBuffer<T>::createCircularBuffer(unsigned int input, bool mirrored /*= false*/)
 {
+	releaseStorage();
 	// --- reset the to top
 	mWriteIndex = 0;
 	// --- init buffer length as power of 2
 	mBufferLength = (unsigned int)(pow(2, ceil(logf(input) / logf(2))));
 	// --- warp mask as (mBufferLength - 1) for binary &= calculation
 	mWrapMask = mBufferLength - 1;
-	// --- direct initialization object into mBufferLength size
-	mBuffer.reset(new T[mBufferLength]);
+
+	if (mirrored && createMapping())
+	{
+		mMirrorMode = kMirrorMapped;
+	}
+	else if (mirrored)
+	{
+		// --- second half holds the same samples as the first one
+		mBuffer.reset(new T[2 * mBufferLength]);
+		mData = mBuffer.get();
+		mMirrorMode = kMirrorCopy;
+	}
+	else
+	{
+		// --- direct initialization object into mBufferLength size
+		mBuffer.reset(new T[mBufferLength]);
+		mData = mBuffer.get();
+		mMirrorMode = kMirrorNone;
+	}
 	// --- clean the value inside mBuffer
 	flushBuffer();
 }
 
+template <typename T>
+bool CircularBuffer<T>::createMapping()
+{
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+	// --- each half has to be whole pages, grow the (power of 2) length until it is
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	while ((sizeof(T) * mBufferLength) % pageSize != 0)
+	{
+		mBufferLength *= 2;
+	}
+	mWrapMask = mBufferLength - 1;
+	size_t bytes = sizeof(T) * mBufferLength;
+
+	int fd = memfd_create("CircularBuffer", MFD_CLOEXEC);
+	if (fd < 0)
+	{
+		return false;
+	}
+	if (ftruncate(fd, (off_t)bytes) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	// --- reserve both halves in one go, then map the file over each of them
+	void* base = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+	{
+		close(fd);
+		return false;
+	}
+
+	char* first = (char*)base;
+	void* lower = mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	void* upper = mmap(first + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	// --- the mappings keep the memory alive, the descriptor is not needed any more
+	close(fd);
+
+	if (lower != first || upper != first + bytes)
+	{
+		munmap(base, 2 * bytes);
+		return false;
+	}
+
+	mMapping = base;
+	mMappingBytes = 2 * bytes;
+	mData = (T*)base;
+	return true;
+#else
+	return false;
+#endif
+}
+
+template <typename T>
+void CircularBuffer<T>::releaseStorage()
+{
+#if defined(__linux__)
+	if (mMapping != nullptr)
+	{
+		munmap(mMapping, mMappingBytes);
+	}
+#endif
+	mMapping = nullptr;
+	mMappingBytes = 0;
+	mBuffer.reset();
+	mData = nullptr;
+	mMirrorMode = kMirrorNone;
+}
+
 template <typename T>
 void CircularBuffer<T>::flushBuffer()
 {
-	for (int i = 0; i < mBufferLength; i++)
+	// --- the mapped mirror shares its pages, only the copy has a second half of its own
+	unsigned int length = mMirrorMode == kMirrorCopy ? 2 * mBufferLength : mBufferLength;
+	for (unsigned int i = 0; i < length; i++)
 	{
-		mBuffer[i] = 0;
+		mData[i] = 0;
 	}
+	mAllpassState = 0;
 }
 
 template <typename T>
 void CircularBuffer<T>::writeBuffer(T input)
 {
-	mBuffer[mWriteIndex++] = input;
+	if (mMirrorMode == kMirrorCopy)
+	{
+		mData[mWriteIndex + mBufferLength] = input;
+	}
+	mData[mWriteIndex++] = input;
 	mWriteIndex &= mWrapMask;
 }
 
+template <typename T>
+void CircularBuffer<T>::writeBuffer(const T* input, int numSamples)
+{
+	// --- at most two copies, up to the end of the ring and then from the top
+	while (numSamples > 0)
+	{
+		int size = mBufferLength - mWriteIndex;
+		size = numSamples < size ? numSamples : size;
+		memcpy(mData + mWriteIndex, input, sizeof(T) * size);
+		if (mMirrorMode == kMirrorCopy)
+		{
+			memcpy(mData + mWriteIndex + mBufferLength, input, sizeof(T) * size);
+		}
+
+		mWriteIndex = (mWriteIndex + size) & mWrapMask;
+		input += size;
+		numSamples -= size;
+	}
+}
+
 template<typename T>
 T CircularBuffer<T>::readBuffer(int delayInSamples)
 {
 	int readIndex = mWriteIndex - delayInSamples;
 	readIndex &= mWrapMask;
-	return mBuffer[readIndex];
+	return mData[readIndex];
 }
 
 template<typename T>
@@ -101,57 +325,284 @@ T CircularBuffer<T>::readBuffer(double delayInFractionalSamples, bool interpolat
 }
 
 template<typename T>
-float CircularBuffer<T>::doLinearInterpolation(float delayInFractionalSamples)
+void CircularBuffer<T>::readBuffer(T* output, int numSamples, int delayInSamples)
 {
-	float y1 = readBuffer((int)delayInFractionalSamples);
-	float y2 = readBuffer((int)delayInFractionalSamples + 1);
-	float fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+	auto spans = getContiguousSpans(numSamples, delayInSamples);
+	memcpy(output, spans.data1, sizeof(T) * spans.size1);
+	if (spans.size2 > 0)
+	{
+		memcpy(output + spans.size1, spans.data2, sizeof(T) * spans.size2);
+	}
+}
 
-	if (fraction >= 1.0) return y2;
-	return fraction * y2 + (1 - fraction) * y1;
+template<typename T>
+typename CircularBuffer<T>::Spans CircularBuffer<T>::getContiguousSpans(int numSamples, int delayInSamples)
+{
+	// --- same indexing as readBuffer(delayInSamples), oldest sample first
+	unsigned int readIndex = (mWriteIndex - delayInSamples) & mWrapMask;
+	if (mMirrorMode != kMirrorNone)
+	{
+		// --- the run continues into the mirror, never wraps, as long as it is no longer than the ring
+		CIRCULAR_BUFFER_ASSERT(numSamples <= (int)mBufferLength);
+		return { mData + readIndex, numSamples, mData, 0 };
+	}
+
+	int size1 = mBufferLength - readIndex;
+	size1 = numSamples < size1 ? numSamples : size1;
+
+	return { mData + readIndex, size1, mData, numSamples - size1 };
 }
 
 template<typename T>
-float CircularBuffer<T>::doHermitInterpolation(float delayInFractionalSamples)
+const T* CircularBuffer<T>::getContiguousBlock(int numSamples, int delayInSamples)
 {
+	if (mMirrorMode == kMirrorNone || numSamples > (int)mBufferLength)
+	{
+		return nullptr;
+	}
+	return mData + ((mWriteIndex - delayInSamples) & mWrapMask);
+}
+
+template<typename T>
+void CircularBuffer<T>::readTaps(T* taps, int firstDelay, int numTaps)
+{
+	if (mMirrorMode != kMirrorNone)
+	{
+		// --- oldest tap first in memory, the mirror covers the run so there is no masking per tap
+		const T* oldest = mData + ((mWriteIndex - (firstDelay + numTaps - 1)) & mWrapMask);
+		for (int k = 0; k < numTaps; k++)
+		{
+			taps[k] = oldest[numTaps - 1 - k];
+		}
+	}
+	else
+	{
+		for (int k = 0; k < numTaps; k++)
+		{
+			taps[k] = mData[(mWriteIndex - (firstDelay + k)) & mWrapMask];
+		}
+	}
+}
+
+template<typename T>
+template<int Interpolation, int Order>
+T CircularBuffer<T>::readInterpolated(float delayInFractionalSamples)
+{
+	static_assert(Order >= 1 && Order <= 15, "lagrange order out of range");
+
 	int index = (int)delayInFractionalSamples;
-	float xm1 = readBuffer(index - 1);;
-	float x0 = readBuffer(index);
-	float x1 = readBuffer(index + 1);
-	float x2 = readBuffer(index + 2);
+	T fraction = delayInFractionalSamples - index;
 
-	float frac_pos = delayInFractionalSamples - (int)delayInFractionalSamples;
+	if constexpr (Interpolation == kInterpolateLinear)
+	{
+		T x[2];
+		readTaps(x, index, 2);
+		return x[0] + fraction * (x[1] - x[0]);
+	}
+	else if constexpr (Interpolation == kInterpolateHermite)
+	{
+		// --- x[0..3] = xm1, x0, x1, x2
+		T x[4];
+		readTaps(x, index - 1, 4);
 
-	const float c = (x1 - xm1) * 0.5f;
-	const float v = x0 - x1;
-	const float w = c + v;
-	const float a = w + v + (x2 - x0) * 0.5f;
-	const float b_neg = w + a;
-	return ((((a * frac_pos) - b_neg) * frac_pos + c) * frac_pos + x0);
+		const T c = (x[2] - x[0]) * 0.5f;
+		const T v = x[1] - x[2];
+		const T w = c + v;
+		const T a = w + v + (x[3] - x[1]) * 0.5f;
+		const T b_neg = w + a;
+		return ((((a * fraction) - b_neg) * fraction + c) * fraction + x[1]);
+	}
+	else if constexpr (Interpolation == kInterpolateLagrange)
+	{
+		static constexpr LagrangeWeights<Order> weights;
+		constexpr int numTaps = Order + 1;
+		// --- nodes are centred on the read position, (index - 1 .. index + 2) for the 3rd order
+		const int first = index - (Order - 1) / 2;
+		const T t = delayInFractionalSamples - first;
+
+		T y[numTaps];
+		readTaps(y, first, numTaps);
+
+		// --- prod over j != i of (t - j) from prefix and suffix products, no divisions left
+		T prefix[numTaps];
+		T product = 1;
+		for (int i = 0; i < numTaps; i++)
+		{
+			prefix[i] = product;
+			product *= t - i;
+		}
+
+		T interpolation = 0;
+		T suffix = 1;
+		for (int i = numTaps - 1; i >= 0; i--)
+		{
+			interpolation += y[i] * weights.weight[i] * prefix[i] * suffix;
+			suffix *= t - i;
+		}
+		return interpolation;
+	}
+	else
+	{
+		static_assert(Interpolation == kInterpolateAllpass, "unknown interpolation type");
+
+		// --- keep the coefficient away from -1 where the allpass gets slow and rings
+		if (fraction < 0.618f && index >= 1)
+		{
+			fraction += 1;
+			index--;
+		}
+
+		T x[2];
+		readTaps(x, index, 2);
+		if (fraction == 0)
+		{
+			mAllpassState = x[0];
+			return x[0];
+		}
+
+		const T alpha = (1 - fraction) / (1 + fraction);
+		mAllpassState = x[1] + alpha * (x[0] - mAllpassState);
+		return mAllpassState;
+	}
 }
 
 template<typename T>
-float CircularBuffer<T>::doLagrangeInterpolation(float delayInFractionalSamples)
+template<int Interpolation, int Order>
+void CircularBuffer<T>::readBuffer(T* output, const float* delaysInFractionalSamples, int numSamples)
 {
-	int n = 4;
-	int index = (int)delayInFractionalSamples;
-	float x[4] = { index - 1, index, index + 1, index + 2 };
-	float y[4] = { readBuffer(index - 1), readBuffer(index), readBuffer(index + 1), readBuffer(index + 2) };
+	// --- the allpass carries its state from one read to the next and a linear read is cheaper than
+	// --- a chunk's gather, both stay one sample at a time
+	if constexpr (Interpolation == kInterpolateHermite || Interpolation == kInterpolateLagrange)
+	{
+		if (mMirrorMode != kMirrorNone)
+		{
+			for (int start = 0; start < numSamples; start += maxChunkSize)
+			{
+				int chunkSize = numSamples - start < maxChunkSize ? numSamples - start : maxChunkSize;
+				readMirroredChunk<Interpolation, Order>(output + start, delaysInFractionalSamples + start, chunkSize, numSamples - 1 - start);
+			}
+			return;
+		}
+	}
+
+	// --- sample i of the block sits (numSamples - 1 - i) behind the write position
+	for (int i = 0; i < numSamples; i++)
+	{
+		output[i] = readInterpolated<Interpolation, Order>(delaysInFractionalSamples[i] + (float)(numSamples - 1 - i));
+	}
+}
+
+template<typename T>
+template<int Interpolation, int Order>
+void CircularBuffer<T>::readMirroredChunk(T* output, const float* delaysInFractionalSamples, int numSamples, int age)
+{
+	static_assert(Order >= 1 && Order <= 15, "lagrange order out of range");
+
+	// --- read i takes the samples (index[i] + firstTap .. index[i] + firstTap + numTaps - 1) behind the write position
+	constexpr int numTaps = Interpolation == kInterpolateHermite ? 4 : Order + 1;
+	constexpr int firstTap = Interpolation == kInterpolateHermite ? -1 : -((Order - 1) / 2);
+
+	int index[maxChunkSize];
+	T fraction[maxChunkSize];
+	int lowest = 0;
+	int highest = 0;
+	for (int i = 0; i < numSamples; i++)
+	{
+		float delay = delaysInFractionalSamples[i] + (float)(age - i);
+		index[i] = (int)delay;
+		fraction[i] = delay - index[i];
+		lowest = i == 0 || index[i] < lowest ? index[i] : lowest;
+		highest = i == 0 || index[i] > highest ? index[i] : highest;
+	}
 
-	float interpolation = 0;
-	for (int i = 0; i < n; i++)
+	// --- a tap in front of the write position or past the ring, the masked reads handle those
+	if (lowest + firstTap < 0 || highest + firstTap + numTaps - 1 > (int)mBufferLength)
 	{
-		float term = y[i];
-		for (int j = 0; j < n; j++)
+		for (int i = 0; i < numSamples; i++)
+		{
+			output[i] = readInterpolated<Interpolation, Order>(delaysInFractionalSamples[i] + (float)(age - i));
+		}
+		return;
+	}
+
+	// --- newest[-d] is the sample d behind the write position, the second half of the mirror holds every tap
+	const T* newest = mData + mBufferLength + mWriteIndex;
+	T taps[numTaps][maxChunkSize];
+	for (int k = 0; k < numTaps; k++)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			taps[k][i] = newest[-(index[i] + firstTap + k)];
+		}
+	}
+
+	// --- from here on every loop runs across the chunk with no dependence between reads, so it vectorises
+	if constexpr (Interpolation == kInterpolateHermite)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			const T c = (taps[2][i] - taps[0][i]) * 0.5f;
+			const T v = taps[1][i] - taps[2][i];
+			const T w = c + v;
+			const T a = w + v + (taps[3][i] - taps[1][i]) * 0.5f;
+			const T b_neg = w + a;
+			output[i] = ((((a * fraction[i]) - b_neg) * fraction[i] + c) * fraction[i] + taps[1][i]);
+		}
+	}
+	else
+	{
+		// --- same prefix and suffix products as readInterpolated, one row of the chunk per node
+		static constexpr LagrangeWeights<Order> weights;
+		T t[maxChunkSize];
+		T product[maxChunkSize];
+		T prefix[numTaps][maxChunkSize];
+		for (int i = 0; i < numSamples; i++)
+		{
+			t[i] = fraction[i] - firstTap;
+			product[i] = 1;
+			output[i] = 0;
+		}
+		for (int k = 0; k < numTaps; k++)
 		{
-			if (j != i)
+			for (int i = 0; i < numSamples; i++)
 			{
-				term = term * (delayInFractionalSamples - x[j]) / (float)(x[i] - x[j]);
+				prefix[k][i] = product[i];
+				product[i] *= t[i] - k;
+			}
+		}
+
+		// --- product starts again as the suffix
+		for (int i = 0; i < numSamples; i++)
+		{
+			product[i] = 1;
+		}
+		for (int k = numTaps - 1; k >= 0; k--)
+		{
+			for (int i = 0; i < numSamples; i++)
+			{
+				output[i] += taps[k][i] * weights.weight[k] * prefix[k][i] * product[i];
+				product[i] *= t[i] - k;
 			}
 		}
-		interpolation += term;
 	}
-	return interpolation;
+}
+
+template<typename T>
+float CircularBuffer<T>::doLinearInterpolation(float delayInFractionalSamples)
+{
+	return readInterpolated<kInterpolateLinear>(delayInFractionalSamples);
+}
+
+template<typename T>
+float CircularBuffer<T>::doHermitInterpolation(float delayInFractionalSamples)
+{
+	return readInterpolated<kInterpolateHermite>(delayInFractionalSamples);
+}
+
+template<typename T>
+float CircularBuffer<T>::doLagrangeInterpolation(float delayInFractionalSamples)
+{
+	return readInterpolated<kInterpolateLagrange, 3>(delayInFractionalSamples);
 }
 
 
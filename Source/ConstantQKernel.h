@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    ConstantQKernel.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <complex>
+#include <vector>
+
+#include "SpectrumKernels.h"
+#include "WindowTable.h"
+
+//==============================================================================
+/**
+	Constant-Q bands computed from an existing FFT frame (Brown and Puckette).
+
+	Band b sits at minFrequency * 2^(b / bandsPerOctave). Its temporal kernel is
+	a Hann window Q periods long carrying a complex exponential at the band
+	frequency, centred in the analysis frame; bands low enough to need more than
+	the frame use the whole frame. By Parseval the band is the inner product of
+	the frame's spectrum with the kernel's spectrum, which is concentrated around
+	the band frequency, so only the bins above a small fraction of the kernel
+	peak are kept.
+
+	The kept bins of a row are contiguous, so the matrix is stored as CSR with
+	just the first column per row, and each row is one SIMD complex dot product
+	over consecutive bins. Kernel spectra come from the closed form of the Hann
+	window, the tables are only rebuilt when the band layout, the sample rate,
+	the transform, the window size or the window changes.
+
+	Values are scaled so a sine at a band frequency gives the same magnitude as
+	a bin-centred sine in the plain FFT, the processor's full scale reference
+	applies to both.
+*/
+class ConstantQKernel
+{
+public:
+	static constexpr double minFrequency = 20.0;
+
+	ConstantQKernel()
+	{
+		mBandsPerOctave = 0;
+		mSampleRate = 0.0;
+		mFFTSize = 0;
+		mWindowSize = 0;
+		mWindowTag = 0;
+	};
+
+	~ConstantQKernel()
+	{
+	};
+
+	// --- returns true when the tables had to be rebuilt
+	bool createConstantQKernel(int bandsPerOctave, double sampleRate, int fftSize, int windowSize, int windowTag);
+
+	int getNumBands() const { return (int)mFirstBin.size(); }
+	int getNumNonZeros() const { return (int)mValues.size(); }
+
+	// --- power[b] = scale * |row b . bins|^2 for every band
+	void apply(const std::complex<float>* bins, float* power, float scale) const;
+
+	// --- bands from minFrequency up to the last one whose centre is below nyquist
+	static int getNumBands(int bandsPerOctave, double sampleRate);
+	static double getBandFrequency(int band, int bandsPerOctave);
+	// --- position 0..1 of a frequency along the band axis, for the editor's grid
+	static float frequencyToProportion(float frequency, int bandsPerOctave, double sampleRate);
+
+private:
+	// --- spectrum of a periodic Hann window of length M shifted by theta, up to a linear phase
+	static std::complex<double> hannSpectrum(double theta, int M);
+	static std::complex<double> dirichlet(double phi, int M);
+
+	// --- relative to the peak of each kernel, the value Brown and Puckette used
+	static constexpr double sparsityThreshold = 0.0054;
+	// --- window samples per kernel when measuring the product with the frame window
+	static constexpr int maxOverlapSamples = 2048;
+
+	std::vector<int> mRowStart;
+	std::vector<int> mFirstBin;
+	std::vector<std::complex<float>> mValues;
+	int mBandsPerOctave;
+	double mSampleRate;
+	int mFFTSize;
+	int mWindowSize;
+	int mWindowTag;
+};
+
+inline int ConstantQKernel::getNumBands(int bandsPerOctave, double sampleRate)
+{
+	if (bandsPerOctave <= 0 || sampleRate <= 2.0 * minFrequency)
+	{
+		return 0;
+	}
+	return (int)floor(bandsPerOctave * log2(sampleRate * 0.5 / minFrequency)) + 1;
+}
+
+inline double ConstantQKernel::getBandFrequency(int band, int bandsPerOctave)
+{
+	return minFrequency * pow(2.0, (double)band / bandsPerOctave);
+}
+
+inline float ConstantQKernel::frequencyToProportion(float frequency, int bandsPerOctave, double sampleRate)
+{
+	auto numBands = getNumBands(bandsPerOctave, sampleRate);
+	if (numBands < 2 || frequency <= 0.0f)
+	{
+		return 0.0f;
+	}
+	return (float)(bandsPerOctave * log2(frequency / minFrequency) / (numBands - 1));
+}
+
+inline std::complex<double> ConstantQKernel::dirichlet(double phi, int M)
+{
+	// --- sum of exp(i phi m) for m = 0 .. M - 1
+	auto denominator = sin(0.5 * phi);
+	auto magnitude = fabs(denominator) < 1.0e-12 ? (double)M : sin(0.5 * M * phi) / denominator;
+	return std::polar(magnitude, 0.5 * (M - 1) * phi);
+}
+
+inline std::complex<double> ConstantQKernel::hannSpectrum(double theta, int M)
+{
+	auto step = 2.0 * M_PI / M;
+	return 0.5 * dirichlet(theta, M) - 0.25 * (dirichlet(theta - step, M) + dirichlet(theta + step, M));
+}
+
+inline bool ConstantQKernel::createConstantQKernel(int bandsPerOctave, double sampleRate, int fftSize, int windowSize, int windowTag)
+{
+	if (bandsPerOctave == mBandsPerOctave && sampleRate == mSampleRate && fftSize == mFFTSize
+		&& windowSize == mWindowSize && windowTag == mWindowTag)
+	{
+		return false;
+	}
+
+	mBandsPerOctave = bandsPerOctave;
+	mSampleRate = sampleRate;
+	mFFTSize = fftSize;
+	mWindowSize = windowSize;
+	mWindowTag = windowTag;
+
+	auto numBands = getNumBands(bandsPerOctave, sampleRate);
+	auto numBins = fftSize / 2 + 1;
+	auto Q = 1.0 / (pow(2.0, 1.0 / bandsPerOctave) - 1.0);
+
+	mRowStart.assign(1, 0);
+	mFirstBin.clear();
+	mValues.clear();
+
+	// --- the frame window's sum, the plain FFT of a bin-centred sine peaks at half of it
+	auto frameStride = windowSize > maxOverlapSamples ? windowSize / maxOverlapSamples : 1;
+	double frameSum = 0.0;
+	for (int n = 0; n < windowSize; n += frameStride)
+		frameSum += WindowTable::getWindowValue(windowTag, n, windowSize) * frameStride;
+
+	std::vector<std::complex<double>> row;
+	for (int band = 0; band < numBands; band++)
+	{
+		auto frequency = getBandFrequency(band, bandsPerOctave);
+		auto length = (int)ceil(Q * sampleRate / frequency);
+		length = length < 2 ? 2 : (length > windowSize ? windowSize : length);
+		auto start = (windowSize - length) / 2;
+
+		// --- the frame is already windowed, so a sine sees the product of both windows
+		auto stride = length > maxOverlapSamples ? length / maxOverlapSamples : 1;
+		double overlap = 0.0;
+		for (int m = 0; m < length; m += stride)
+		{
+			auto hann = 0.5 - 0.5 * cos(2.0 * M_PI * m / length);
+			overlap += hann * WindowTable::getWindowValue(windowTag, start + m, windowSize) * stride;
+		}
+		auto scale = overlap > 0.0 ? frameSum / (overlap * fftSize) : 0.0;
+
+		// --- main lobe is 4 kernel bins wide, the side lobes past 10 of them are far below the threshold
+		auto centre = frequency * fftSize / sampleRate;
+		auto halfWidth = 10.0 * fftSize / length + 2.0;
+		auto first = (int)floor(centre - halfWidth);
+		auto last = (int)ceil(centre + halfWidth);
+		first = first < 0 ? 0 : first;
+		last = last > numBins - 1 ? numBins - 1 : last;
+
+		row.resize(last - first + 1 > 0 ? last - first + 1 : 0);
+		double peak = 0.0;
+		for (int k = first; k <= last; k++)
+		{
+			auto theta = 2.0 * M_PI * ((double)k / fftSize - frequency / sampleRate);
+			auto value = std::polar(scale, theta * start) * hannSpectrum(theta, length);
+			row[k - first] = value;
+			peak = std::abs(value) > peak ? std::abs(value) : peak;
+		}
+
+		// --- trimmed from both ends, small values inside the band stay so the row is one run
+		auto limit = peak * sparsityThreshold;
+		auto begin = 0;
+		auto end = (int)row.size();
+		while (begin < end && std::abs(row[begin]) < limit)
+			begin++;
+		while (end > begin && std::abs(row[end - 1]) < limit)
+			end--;
+
+		mFirstBin.push_back(first + begin);
+		for (int i = begin; i < end; i++)
+			mValues.push_back(std::complex<float>((float)row[i].real(), (float)row[i].imag()));
+		mRowStart.push_back((int)mValues.size());
+	}
+
+	return true;
+}
+
+inline void ConstantQKernel::apply(const std::complex<float>* bins, float* power, float scale) const
+{
+	auto numBands = getNumBands();
+	for (int band = 0; band < numBands; band++)
+	{
+		auto start = mRowStart[band];
+		auto value = SpectrumKernels::complexDot(mValues.data() + start, bins + mFirstBin[band], mRowStart[band + 1] - start);
+		power[band] = scale * std::norm(value);
+	}
+}
@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    FFTBackend.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "FFTBackend.h"
+#include "SlicedFFT.h"
+
+#if SPECTROGRAM_USE_PFFFT
+ #include <pffft.h>
+#endif
+
+#if SPECTROGRAM_USE_POCKETFFT
+ #include <pocketfft_hdronly.h>
+#endif
+
+#if SPECTROGRAM_USE_FFTW
+ #include <fftw3.h>
+#endif
+
+//==============================================================================
+// juce::dsp::FFT, ipp or fftw when juce was built with them, the generic fallback otherwise.
+// the fallback holds a spin lock for the whole transform, so threads sharing one juce::dsp::FFT
+// take turns; every caller borrows an engine of its own instead, built the first time it is needed
+class JuceFFTBackend : public FFTBackend
+{
+public:
+	JuceFFTBackend(int order, bool isComplex)
+		: FFTBackend(1 << order, isComplex), order(order)
+	{
+		// --- one engine up front, a single caller never allocates
+		engines[0].fft = std::make_unique<juce::dsp::FFT>(order);
+	}
+
+	int getType() const override { return kFFTBackendJuce; }
+	const char* getName() const override { return "JUCE"; }
+
+	void performRealForward(const float* input, float* output, float* /*work*/) const override
+	{
+		auto& engine = claimEngine();
+
+		// in place only
+		memcpy(output, input, sizeof(float) * size);
+		engine.fft->performRealOnlyForwardTransform(output, true);
+
+		engine.isBusy.store(false, std::memory_order_release);
+	}
+
+	void performComplexForward(const float* input, float* output, float* /*work*/) const override
+	{
+		auto& engine = claimEngine();
+
+		engine.fft->perform(reinterpret_cast<const juce::dsp::Complex<float>*>(input),
+			reinterpret_cast<juce::dsp::Complex<float>*>(output), false);
+
+		engine.isBusy.store(false, std::memory_order_release);
+	}
+
+private:
+	struct Engine
+	{
+		std::atomic<bool> isBusy { false };
+		// --- only touched by the thread that holds isBusy
+		std::unique_ptr<juce::dsp::FFT> fft;
+	};
+
+	Engine& claimEngine() const
+	{
+		for (;;)
+		{
+			for (auto& engine : engines)
+			{
+				if (!engine.isBusy.load(std::memory_order_relaxed) && !engine.isBusy.exchange(true, std::memory_order_acquire))
+				{
+					if (engine.fft == nullptr)
+						engine.fft = std::make_unique<juce::dsp::FFT>(order);
+					return engine;
+				}
+			}
+			// more callers than engines, one of them is about to finish
+			juce::Thread::yield();
+		}
+	}
+
+	// --- more than the pool threads of every instance and cli job that could share a plan
+	static constexpr int maxNumEngines = 64;
+
+	const int order;
+	mutable Engine engines[maxNumEngines];
+};
+
+#if SPECTROGRAM_USE_PFFFT
+//==============================================================================
+class PffftBackend : public FFTBackend
+{
+public:
+	// --- pffft needs at least 32 real or 16 complex points, setup is null below that
+	PffftBackend(int order, bool isComplex)
+		: FFTBackend(1 << order, isComplex), setup(pffft_new_setup(1 << order, isComplex ? PFFFT_COMPLEX : PFFFT_REAL))
+	{
+	}
+
+	~PffftBackend() override
+	{
+		if (setup != nullptr)
+			pffft_destroy_setup(setup);
+	}
+
+	bool isValid() const { return setup != nullptr; }
+	int getType() const override { return kFFTBackendPffft; }
+	const char* getName() const override { return "PFFFT"; }
+	int getWorkSize() const override { return complex ? 2 * size : size; }
+
+	void performRealForward(const float* input, float* output, float* work) const override
+	{
+		jassert(!complex);
+		// ordered output already has bins 1 .. N / 2 - 1 in place, dc and nyquist share the first pair
+		pffft_transform_ordered(setup, input, output, work, PFFFT_FORWARD);
+		output[size] = output[1];
+		output[size + 1] = 0.0f;
+		output[1] = 0.0f;
+	}
+
+	void performComplexForward(const float* input, float* output, float* work) const override
+	{
+		jassert(complex);
+		pffft_transform_ordered(setup, input, output, work, PFFFT_FORWARD);
+	}
+
+private:
+	PFFFT_Setup* setup;
+};
+#endif
+
+#if SPECTROGRAM_USE_POCKETFFT
+//==============================================================================
+// allocates a temporary per call, fine on the pool threads but never on the audio thread
+class PocketfftBackend : public FFTBackend
+{
+public:
+	PocketfftBackend(int order, bool isComplex)
+		: FFTBackend(1 << order, isComplex)
+	{
+		if (isComplex)
+			complexPlan = std::make_unique<pocketfft::detail::pocketfft_c<float>>((size_t)size);
+		else
+			realPlan = std::make_unique<pocketfft::detail::pocketfft_r<float>>((size_t)size);
+	}
+
+	int getType() const override { return kFFTBackendPocketfft; }
+	const char* getName() const override { return "pocketfft"; }
+
+	void performRealForward(const float* input, float* output, float* /*work*/) const override
+	{
+		// in place only, fftpack order r0, r1, i1, .. r(N/2) is spread out from the top so nothing is overwritten before it is read
+		jassert(!complex);
+		memcpy(output, input, sizeof(float) * size);
+		realPlan->exec(output, 1.0f, true);
+		output[size] = output[size - 1];
+		output[size + 1] = 0.0f;
+		for (int k = size / 2 - 1; k >= 1; k--)
+		{
+			output[2 * k + 1] = output[2 * k];
+			output[2 * k] = output[2 * k - 1];
+		}
+		output[1] = 0.0f;
+	}
+
+	void performComplexForward(const float* input, float* output, float* /*work*/) const override
+	{
+		// in place only as well, cmplx<float> is a plain re, im pair
+		jassert(complex);
+		memcpy(output, input, sizeof(float) * 2 * size);
+		complexPlan->exec(reinterpret_cast<pocketfft::detail::cmplx<float>*>(output), 1.0f, true);
+	}
+
+private:
+	std::unique_ptr<pocketfft::detail::pocketfft_r<float>> realPlan;
+	std::unique_ptr<pocketfft::detail::pocketfft_c<float>> complexPlan;
+};
+#endif
+
+#if SPECTROGRAM_USE_FFTW
+//==============================================================================
+class FftwBackend : public FFTBackend
+{
+public:
+	FftwBackend(int order, bool isComplex)
+		: FFTBackend(1 << order, isComplex)
+	{
+		// the planner is not thread safe, wisdom makes FFTW_MEASURE cheap after the first run
+		const juce::ScopedLock sl(getPlannerLock());
+		auto wisdom = getWisdomFile();
+		fftwf_import_wisdom_from_filename(wisdom.getFullPathName().toRawUTF8());
+
+		// out of place r2c and c2c keep their input by default
+		auto* input = fftwf_alloc_complex(size);
+		auto* output = fftwf_alloc_complex(size);
+		if (isComplex)
+			plan = fftwf_plan_dft_1d(size, input, output, FFTW_FORWARD, FFTW_MEASURE | FFTW_UNALIGNED);
+		else
+			plan = fftwf_plan_dft_r2c_1d(size, reinterpret_cast<float*>(input), output, FFTW_MEASURE | FFTW_UNALIGNED);
+		fftwf_free(input);
+		fftwf_free(output);
+
+		wisdom.getParentDirectory().createDirectory();
+		fftwf_export_wisdom_to_filename(wisdom.getFullPathName().toRawUTF8());
+	}
+
+	~FftwBackend() override
+	{
+		const juce::ScopedLock sl(getPlannerLock());
+		if (plan != nullptr)
+			fftwf_destroy_plan(plan);
+	}
+
+	bool isValid() const { return plan != nullptr; }
+	int getType() const override { return kFFTBackendFftw; }
+	const char* getName() const override { return "FFTW"; }
+
+	void performRealForward(const float* input, float* output, float* /*work*/) const override
+	{
+		// new-array execute is thread safe, out of place like the plan
+		jassert(!complex);
+		fftwf_execute_dft_r2c(plan, const_cast<float*>(input), reinterpret_cast<fftwf_complex*>(output));
+	}
+
+	void performComplexForward(const float* input, float* output, float* /*work*/) const override
+	{
+		jassert(complex);
+		fftwf_execute_dft(plan, reinterpret_cast<fftwf_complex*>(const_cast<float*>(input)), reinterpret_cast<fftwf_complex*>(output));
+	}
+
+private:
+	static juce::CriticalSection& getPlannerLock()
+	{
+		static juce::CriticalSection plannerLock;
+		return plannerLock;
+	}
+
+	static juce::File getWisdomFile()
+	{
+		return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+			.getChildFile("Spectrogram").getChildFile("fftwf.wisdom");
+	}
+
+	fftwf_plan plan;
+};
+#endif
+
+//==============================================================================
+FFTPlanCache::FFTPlanCache()
+{
+}
+
+FFTPlanCache::~FFTPlanCache()
+{
+}
+
+std::shared_ptr<const FFTBackend> FFTPlanCache::getPlan(int order)
+{
+	return getCachedPlan(plans, order, false);
+}
+
+std::shared_ptr<const FFTBackend> FFTPlanCache::getComplexPlan(int order)
+{
+	return getCachedPlan(complexPlans, order, true);
+}
+
+std::shared_ptr<const FFTBackend> FFTPlanCache::getCachedPlan(std::shared_ptr<const FFTBackend>* cache, int order, bool isComplex)
+{
+	order = juce::jlimit(0, (int)(sizeof(plans) / sizeof(plans[0])) - 1, order);
+
+	const juce::ScopedLock sl(lock);
+	if (cache[order] == nullptr)
+	{
+		std::unique_ptr<FFTBackend> backend;
+		if (SPECTROGRAM_FFT_BACKEND == kFFTBackendAuto)
+			backend = createFastest(order, isComplex);
+		else
+			backend = createBackend(SPECTROGRAM_FFT_BACKEND, order, isComplex);
+
+		if (backend == nullptr)
+			backend = createBackend(kFFTBackendJuce, order, isComplex);
+
+		cache[order] = std::move(backend);
+	}
+
+	return cache[order];
+}
+
+std::shared_ptr<const SlicedFFT> FFTPlanCache::getSlicedPlan(int order)
+{
+	if (order < SPECTROGRAM_SLICED_FFT_ORDER)
+		return nullptr;
+
+	order = juce::jlimit(0, (int)(sizeof(slicedPlans) / sizeof(slicedPlans[0])) - 1, order);
+
+	const juce::ScopedLock sl(lock);
+	if (slicedPlans[order] == nullptr)
+	{
+		auto plan = std::make_shared<SlicedFFT>();
+		plan->createSlicedFFT(order, pointsPerSlice, *this);
+		slicedPlans[order] = std::move(plan);
+	}
+
+	return slicedPlans[order];
+}
+
+std::unique_ptr<FFTBackend> FFTPlanCache::createBackend(int type, int order, bool isComplex /*= false*/)
+{
+	switch (type)
+	{
+	case kFFTBackendJuce:
+		return std::make_unique<JuceFFTBackend>(order, isComplex);
+
+#if SPECTROGRAM_USE_PFFFT
+	case kFFTBackendPffft:
+	{
+		auto backend = std::make_unique<PffftBackend>(order, isComplex);
+		if (backend->isValid())
+			return backend;
+		return nullptr;
+	}
+#endif
+
+#if SPECTROGRAM_USE_POCKETFFT
+	case kFFTBackendPocketfft:
+		return std::make_unique<PocketfftBackend>(order, isComplex);
+#endif
+
+#if SPECTROGRAM_USE_FFTW
+	case kFFTBackendFftw:
+	{
+		auto backend = std::make_unique<FftwBackend>(order, isComplex);
+		if (backend->isValid())
+			return backend;
+		return nullptr;
+	}
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+std::unique_ptr<FFTBackend> FFTPlanCache::createFastest(int order, bool isComplex)
+{
+	auto size = 1 << order;
+	// --- roughly the same amount of work for every size, at least a handful of runs
+	auto numRuns = juce::jmax(4, (1 << 18) >> order);
+
+	// aligned like the pool scratch, input, output then work, the input has room for complex values
+	static constexpr size_t alignment = 64;
+	auto numFloats = (size_t)(4 * size + getMaxWorkSize(size));
+	std::unique_ptr<char[]> storage(new char[numFloats * sizeof(float) + alignment]());
+	auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+	auto* input = reinterpret_cast<float*>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+	auto* output = input + 2 * size;
+	auto* work = output + 2 * size;
+
+	juce::Random random(order);
+	for (int i = 0; i < 2 * size; i++)
+		input[i] = random.nextFloat() * 2.0f - 1.0f;
+
+	std::unique_ptr<FFTBackend> fastest;
+	auto fastestSeconds = std::numeric_limits<double>::max();
+
+	for (int type = kFFTBackendJuce; type <= kFFTBackendFftw; type++)
+	{
+		auto backend = createBackend(type, order, isComplex);
+		if (backend == nullptr)
+			continue;
+
+		auto perform = [&]
+		{
+			if (isComplex)
+				backend->performComplexForward(input, output, work);
+			else
+				backend->performRealForward(input, output, work);
+		};
+
+		// first run warms the caches and lets the backend finish any lazy setup
+		perform();
+
+		auto startTicks = juce::Time::getHighResolutionTicks();
+		for (int run = 0; run < numRuns; run++)
+		{
+			perform();
+		}
+		auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+		if (seconds < fastestSeconds)
+		{
+			fastestSeconds = seconds;
+			fastest = std::move(backend);
+		}
+	}
+
+	return fastest;
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    FFTBackend.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class SlicedFFT;
+
+// --- optional backends, each one needs its headers (and for pffft / fftw the library) on the paths
+#ifndef SPECTROGRAM_USE_PFFFT
+ #define SPECTROGRAM_USE_PFFFT 0
+#endif
+
+#ifndef SPECTROGRAM_USE_POCKETFFT
+ #define SPECTROGRAM_USE_POCKETFFT 0
+#endif
+
+#ifndef SPECTROGRAM_USE_FFTW
+ #define SPECTROGRAM_USE_FFTW 0
+#endif
+
+enum FFTBackendType
+{
+	// --- time every compiled-in backend once per size and keep the fastest
+	kFFTBackendAuto = 0,
+	kFFTBackendJuce,
+	kFFTBackendPffft,
+	kFFTBackendPocketfft,
+	kFFTBackendFftw
+};
+
+// --- build time choice, a backend that is not compiled in falls back to juce
+#ifndef SPECTROGRAM_FFT_BACKEND
+ #define SPECTROGRAM_FFT_BACKEND kFFTBackendAuto
+#endif
+
+// --- transforms of this order and up are run in slices the pool threads share, anything above 16 turns it off
+#ifndef SPECTROGRAM_SLICED_FFT_ORDER
+ #define SPECTROGRAM_SLICED_FFT_ORDER 15
+#endif
+
+//==============================================================================
+/**
+	One forward transform of a fixed size, real or complex.
+
+	performRealForward reads N real samples from input, which it leaves untouched,
+	and writes the N / 2 + 1 complex bins interleaved to output[0..N + 2), the
+	same layout as juce::dsp::FFT::performRealOnlyForwardTransform(data, true).
+	output holds 2 * N floats and work getWorkSize() floats, all three buffers
+	64 byte aligned. Keeping the input intact lets a zero padded frame reuse the
+	same buffer without clearing its tail. One plan per size is shared by the
+	pool threads of every instance and by the jobs of the command line tool, so
+	performRealForward has to be safe to call from several threads at once
+	without them waiting on each other.
+
+	performComplexForward is the complex counterpart, for plans from
+	getComplexPlan: N complex values interleaved from input to N bins in natural
+	order at output, unscaled, same alignment and the same work buffer. The
+	sliced transform runs its short row and column transforms through these.
+*/
+class FFTBackend
+{
+public:
+	virtual ~FFTBackend() = default;
+
+	virtual int getType() const = 0;
+	virtual const char* getName() const = 0;
+	virtual int getWorkSize() const { return 0; }
+	virtual void performRealForward(const float* input, float* output, float* work) const = 0;
+	virtual void performComplexForward(const float* input, float* output, float* work) const = 0;
+
+	int getSize() const { return size; }
+	bool isComplex() const { return complex; }
+
+protected:
+	FFTBackend(int fftSize, bool isComplex) : size(fftSize), complex(isComplex) {}
+
+	const int size;
+	const bool complex;
+};
+
+//==============================================================================
+/**
+	Plans by order, built on first use. The fastest backend for a size is
+	picked by a short benchmark the first time that size is asked for, later
+	setups of the same size share the cached plan.
+*/
+class FFTPlanCache
+{
+public:
+	FFTPlanCache();
+	~FFTPlanCache();
+
+	// --- message thread (or prepareToPlay), may take a few ms the first time an order is used
+	std::shared_ptr<const FFTBackend> getPlan(int order);
+	// --- same for complex transforms of 2^order points
+	std::shared_ptr<const FFTBackend> getComplexPlan(int order);
+	// --- nullptr below SPECTROGRAM_SLICED_FFT_ORDER, those sizes are transformed in one piece
+	std::shared_ptr<const SlicedFFT> getSlicedPlan(int order);
+
+	// --- nullptr when that backend is not compiled in or cannot do the size
+	static std::unique_ptr<FFTBackend> createBackend(int type, int order, bool isComplex = false);
+	// --- upper bound of getWorkSize() over every backend for a transform size, real or complex
+	static int getMaxWorkSize(int fftSize) { return 2 * fftSize; }
+
+private:
+	std::shared_ptr<const FFTBackend> getCachedPlan(std::shared_ptr<const FFTBackend>* cache, int order, bool isComplex);
+	std::unique_ptr<FFTBackend> createFastest(int order, bool isComplex);
+
+	juce::CriticalSection lock;
+	std::shared_ptr<const FFTBackend> plans[32];
+	std::shared_ptr<const FFTBackend> complexPlans[32];
+	std::shared_ptr<const SlicedFFT> slicedPlans[32];
+
+	// --- about 50 us of work per slice on a desktop core
+	static constexpr int pointsPerSlice = 4096;
+
+	JUCE_DECLARE_NON_COPYABLE(FFTPlanCache)
+};
@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    FrequencyAxis.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+#include <vector>
+
+#include "PeakInterpolation.h"
+
+// --- how the bins that fall into one display column are combined, inputs are power (squared magnitude)
+enum AggregationMode
+{
+	kAggregateMax = 1,
+	kAggregateMean,
+	kAggregateRMS,
+	// --- columns narrower than a bin follow a parabola through the neighbouring bins, wider ones take the max
+	kAggregateInterpolate
+};
+
+//==============================================================================
+/**
+	Maps FFT bins onto display columns (points of the line graph, bars, pixel
+	columns or spectrogram rows).
+
+	Column x covers the bins between the skewed edges x / numColumns and
+	(x + 1) / numColumns of the half spectrum, so every bin lands in at least one
+	column and nothing is skipped at large transform sizes. skew = 1 is linear,
+	smaller values stretch the low end. The tables are only rebuilt when the
+	layout, the transform size, the skew or the sample rate changes.
+*/
+class FrequencyAxis
+{
+public:
+	FrequencyAxis()
+	{
+		mNumColumns = 0;
+		mNumBins = 0;
+		mSkew = 0.0f;
+		mSampleRate = 0.0;
+	};
+
+	~FrequencyAxis()
+	{
+	};
+
+	// --- returns true when the tables had to be rebuilt
+	bool createFrequencyAxis(int numColumns, int numBins, float skew, double sampleRate);
+
+	int getNumColumns() const { return mNumColumns; }
+	int getStartBin(int column) const { return mStartBin[column]; }
+	int getEndBin(int column) const { return mStartBin[column + 1] > mStartBin[column] ? mStartBin[column + 1] : mStartBin[column] + 1; }
+
+	void aggregate(const float* power, float* columns, int mode) const;
+	void aggregateMinMax(const float* power, float* minColumns, float* maxColumns) const;
+
+	// --- position 0..1 along the axis for a frequency, inverse of the skewed mapping
+	static float frequencyToProportion(float frequency, double sampleRate, float skew);
+
+private:
+	// --- numColumns + 1 edges, column x covers [mStartBin[x], getEndBin(x))
+	std::vector<int> mStartBin;
+	// --- fractional bin at the centre of each column
+	std::vector<float> mPosition;
+	int mNumColumns;
+	int mNumBins;
+	float mSkew;
+	double mSampleRate;
+};
+
+inline bool FrequencyAxis::createFrequencyAxis(int numColumns, int numBins, float skew, double sampleRate)
+{
+	if (numColumns == mNumColumns && numBins == mNumBins && skew == mSkew && sampleRate == mSampleRate)
+	{
+		return false;
+	}
+
+	// --- without bins there is nothing to map, no column reads any
+	mNumColumns = numColumns < 0 || numBins < 1 ? 0 : numColumns;
+	mNumBins = numBins;
+	mSkew = skew;
+	mSampleRate = sampleRate;
+
+	mStartBin.resize(mNumColumns + 1);
+	mPosition.resize(mNumColumns);
+	for (int x = 0; x <= mNumColumns; x++)
+	{
+		// --- same skew curve the editor always used, evaluated once per edge instead of per frame
+		auto proportion = (float)x / (float)mNumColumns;
+		auto skewedProportion = x < mNumColumns ? 1.0f - expf(logf(1.0f - proportion) * skew) : 1.0f;
+		auto bin = (int)(skewedProportion * (float)(numBins - 1));
+		mStartBin[x] = bin < 0 ? 0 : (bin > numBins - 1 ? numBins - 1 : bin);
+
+		if (x < mNumColumns)
+		{
+			auto centre = ((float)x + 0.5f) / (float)mNumColumns;
+			mPosition[x] = (1.0f - expf(logf(1.0f - centre) * skew)) * (float)(numBins - 1);
+		}
+	}
+	// --- last edge is exclusive so the nyquist bin belongs to the last column
+	if (mNumColumns > 0)
+	{
+		mStartBin[mNumColumns] = numBins;
+	}
+
+	return true;
+}
+
+inline void FrequencyAxis::aggregate(const float* power, float* columns, int mode) const
+{
+	for (int x = 0; x < mNumColumns; x++)
+	{
+		auto start = getStartBin(x);
+		auto end = getEndBin(x);
+
+		if (mode == kAggregateMean)
+		{
+			// --- mean magnitude, squared back to power
+			float sum = 0.0f;
+			for (int k = start; k < end; k++)
+				sum += sqrtf(power[k]);
+			auto mean = sum / (float)(end - start);
+			columns[x] = mean * mean;
+		}
+		else if (mode == kAggregateInterpolate && end - start <= 1)
+		{
+			// --- several columns share this bin, a curve through its neighbours instead of a flat step
+			columns[x] = PeakInterpolation::interpolatePower(power, mNumBins, mPosition[x]);
+		}
+		else if (mode == kAggregateRMS)
+		{
+			// --- mean power is the squared rms magnitude
+			float sum = 0.0f;
+			for (int k = start; k < end; k++)
+				sum += power[k];
+			columns[x] = sum / (float)(end - start);
+		}
+		else
+		{
+			float peak = power[start];
+			for (int k = start + 1; k < end; k++)
+				peak = power[k] > peak ? power[k] : peak;
+			columns[x] = peak;
+		}
+	}
+}
+
+inline void FrequencyAxis::aggregateMinMax(const float* power, float* minColumns, float* maxColumns) const
+{
+	for (int x = 0; x < mNumColumns; x++)
+	{
+		auto start = getStartBin(x);
+		auto end = getEndBin(x);
+
+		float lowest = power[start];
+		float highest = lowest;
+		for (int k = start + 1; k < end; k++)
+		{
+			lowest = power[k] < lowest ? power[k] : lowest;
+			highest = power[k] > highest ? power[k] : highest;
+		}
+		minColumns[x] = lowest;
+		maxColumns[x] = highest;
+	}
+}
+
+inline float FrequencyAxis::frequencyToProportion(float frequency, double sampleRate, float skew)
+{
+	auto proportion = (float)(frequency * 2.0 / sampleRate);
+	return 1.0f - powf(1.0f - proportion, 1.0f / skew);
+}
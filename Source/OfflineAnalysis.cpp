@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    OfflineAnalysis.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "OfflineAnalysis.h"
+
+OfflineAnalysis::OfflineAnalysis(FFTPlanCache& plans)
+	: fftPlans(plans)
+{
+}
+
+OfflineAnalysis::~OfflineAnalysis()
+{
+	analysisPool.releasePool();
+}
+
+void OfflineAnalysis::prepare(const Settings& newSettings, int channels, FrameCallback callback)
+{
+	analysisPool.releasePool();
+
+	settings = newSettings;
+	settings.overlapTag = juce::jlimit(1, 4, settings.overlapTag);
+	frameCallback = std::move(callback);
+
+	// one layer, a file has time for a long window everywhere
+	layout.reset(new AnalysisLayout(settings.fftOrder, settings.paddingOrder, 1, settings.fftOrder, settings.fftOrder + settings.paddingOrder, fftPlans));
+	auto& setup = getSetup();
+	hopSize = setup.windowSize >> (settings.overlapTag - 1);
+
+	// mirrored rings, a window plus every queued hop fits before a frame in flight is overwritten
+	numChannels = juce::jlimit(1, maxNumChannels, channels);
+	channelBuffers.clear();
+	for (int channel = 0; channel < numChannels; channel++)
+	{
+		channelBuffers.add(new CircularBuffer<float>())->createCircularBuffer(setup.windowSize + numQueuedFrames * hopSize, true);
+	}
+
+	spectrumFifo.createFifo(numQueuedFrames, setup.numBins * numChannels);
+	analysisPool.createPool(juce::jmax(1, settings.numThreads), numQueuedFrames, setup.fftSize);
+
+	// first frame once the rings hold a full window
+	samplesUntilNextFrame = setup.windowSize;
+	samplesWritten = 0;
+	numFrames = 0;
+	numSubmitted = 0;
+	numCollected = 0;
+}
+
+void OfflineAnalysis::process(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+	// every ring moves on together, the buffer has to carry each prepared channel
+	jassert(buffer.getNumChannels() >= numChannels);
+
+	// written in chunks that end exactly on frame boundaries, like the processor's blocks
+	for (int i = 0; i < numSamples;)
+	{
+		auto numToWrite = juce::jmin(numSamples - i, samplesUntilNextFrame);
+
+		waitForPosition(samplesWritten + numToWrite);
+		analysisPool.setWritePosition(samplesWritten + numToWrite);
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			channelBuffers[channel]->writeBuffer(buffer.getReadPointer(channel, i), numToWrite);
+		}
+		samplesWritten += numToWrite;
+		i += numToWrite;
+
+		samplesUntilNextFrame -= numToWrite;
+		if (samplesUntilNextFrame <= 0)
+		{
+			samplesUntilNextFrame = hopSize;
+			queueFrame();
+		}
+	}
+
+	collectFrames();
+}
+
+void OfflineAnalysis::finish()
+{
+	while (numCollected < numSubmitted)
+	{
+		if (collectFrames() == 0)
+			juce::Thread::yield();
+	}
+}
+
+void OfflineAnalysis::queueFrame()
+{
+	// every slot is taken, the writer waits for the oldest frame instead of skipping this one
+	while (numSubmitted - numCollected >= numQueuedFrames)
+	{
+		if (collectFrames() == 0)
+			juce::Thread::yield();
+	}
+
+	auto* job = analysisPool.beginJob();
+	auto* frame = spectrumFifo.beginWrite();
+	jassert(job != nullptr && frame != nullptr);
+
+	auto& setup = getSetup();
+	auto windowSize = setup.windowSize;
+	for (int channel = 0; channel < numChannels; channel++)
+	{
+		job->spans[channel] = channelBuffers[channel]->getContiguousSpans(windowSize, windowSize);
+	}
+	job->frame = frame;
+	job->setup = &setup;
+	job->window = setup.windowTable.getWindow(settings.windowTag);
+	job->numSources = numChannels;
+	// rings hold the frame until they have been written ringLength - windowSize further
+	job->deadline = samplesWritten + (juce::int64)channelBuffers[0]->getBufferLength() - windowSize;
+	deadlines[numSubmitted % numQueuedFrames] = job->deadline;
+
+	frame->numSources = numChannels;
+	frame->numBins = setup.numBins;
+	frame->fftSize = setup.fftSize;
+	frame->windowSize = windowSize;
+	frame->windowTag = settings.windowTag;
+	frame->hopSize = hopSize;
+	frame->layer = 0;
+	frame->numLayers = 1;
+	frame->coherentGain = setup.windowTable.getCoherentGain(settings.windowTag);
+	frame->enbw = setup.windowTable.getENBW(settings.windowTag);
+	frame->samplePosition = samplesWritten;
+	analysisPool.submitJob();
+	numSubmitted++;
+}
+
+int OfflineAnalysis::collectFrames()
+{
+	auto numFinished = 0;
+	while (auto* job = analysisPool.getFinishedJob())
+	{
+		// the writer never runs past a deadline, an expired frame would mean the rings are too short
+		jassert(!job->expired.load(std::memory_order_relaxed));
+		if (job->expired.load(std::memory_order_relaxed))
+		{
+			job->frame->numSources = 0;
+		}
+		spectrumFifo.finishWrite();
+		analysisPool.retireJob();
+		numCollected++;
+		numFinished++;
+
+		if (auto* frame = spectrumFifo.beginRead())
+		{
+			if (frame->numSources > 0 && frameCallback != nullptr)
+			{
+				frameCallback(*frame);
+				numFrames++;
+			}
+			spectrumFifo.finishRead();
+		}
+	}
+	return numFinished;
+}
+
+void OfflineAnalysis::waitForPosition(juce::int64 position)
+{
+	while (numCollected < numSubmitted && deadlines[numCollected % numQueuedFrames] < position)
+	{
+		if (collectFrames() == 0)
+			juce::Thread::yield();
+	}
+}
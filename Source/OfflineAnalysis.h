@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    OfflineAnalysis.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <functional>
+
+#include "CircularBuffer.h"
+#include "AnalysisSetup.h"
+#include "SpectrumFifo.h"
+#include "AnalysisThreadPool.h"
+
+//==============================================================================
+/**
+	Runs the plugin's analysis over recorded audio rather than a live input.
+
+	It uses the same pieces as puannhiAudioProcessor: a mirrored ring per
+	channel, an AnalysisLayout for the window and the plan, the
+	AnalysisThreadPool for the windowing and the transforms, and a SpectrumFifo
+	for the frames. The hop scheduler is the same too. Only the hand-off
+	differs. Nothing here is real-time, so the writer never drops a frame. It
+	waits for the pool whenever every slot is taken, or when the next samples
+	would overwrite a frame still in flight. Every frame reaches the callback,
+	in order, on the thread that calls process.
+*/
+class OfflineAnalysis
+{
+public:
+	static constexpr int maxNumChannels = AnalysisThreadPool::maxNumSources;
+
+	struct Settings
+	{
+		// window length is 2^fftOrder, zero padding makes the transform 2^paddingOrder times longer
+		int fftOrder = 11;
+		int paddingOrder = 0;
+		int windowTag = kHanning;
+		// 1 = 0%, 2 = 50%, 3 = 75%, 4 = 87.5% overlap between consecutive frames
+		int overlapTag = 3;
+		int numThreads = 1;
+	};
+
+	// --- numSources half spectra per frame, one per channel, as the plugin's frames carry them
+	using FrameCallback = std::function<void(const SpectrumFrame&)>;
+
+	explicit OfflineAnalysis(FFTPlanCache& plans);
+	~OfflineAnalysis();
+
+	void prepare(const Settings& newSettings, int numChannels, FrameCallback callback);
+	// --- the first numSamples of the prepared channels of buffer, blocks of any length
+	void process(const juce::AudioBuffer<float>& buffer, int numSamples);
+	// --- waits for the frames still on the pool, a tail shorter than a hop gets no frame of its own
+	void finish();
+
+	const AnalysisSetup& getSetup() const { return *layout->layers[0]; }
+	int getHopSize() const { return hopSize; }
+	juce::int64 getNumFrames() const { return numFrames; }
+
+private:
+	void queueFrame();
+	// --- hands every finished frame to the callback, returns how many there were
+	int collectFrames();
+	// --- blocks until no frame in flight still needs the samples a write up to position overwrites
+	void waitForPosition(juce::int64 position);
+
+	// --- enough to keep every thread busy, the rings hold this many hops beyond one window
+	static constexpr int numQueuedFrames = 32;
+
+	FFTPlanCache& fftPlans;
+	Settings settings;
+	FrameCallback frameCallback;
+	std::unique_ptr<AnalysisLayout> layout;
+	juce::OwnedArray<CircularBuffer<float>> channelBuffers;
+	SpectrumFifo spectrumFifo;
+	int numChannels = 0;
+	int hopSize = 0;
+	int samplesUntilNextFrame = 0;
+	juce::int64 samplesWritten = 0;
+	juce::int64 numFrames = 0;
+
+	// --- deadlines of the frames in flight, the oldest one at numCollected
+	juce::int64 deadlines[numQueuedFrames] = {};
+	juce::int64 numSubmitted = 0;
+	juce::int64 numCollected = 0;
+
+	// --- declared last, so its threads are gone before the rings and the layout they read
+	AnalysisThreadPool analysisPool;
+
+	JUCE_DECLARE_NON_COPYABLE(OfflineAnalysis)
+};
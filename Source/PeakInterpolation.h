@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    PeakInterpolation.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+
+//==============================================================================
+/**
+	Estimates between bins from three neighbours, a cheap alternative to zero
+	padding when only the shape around a bin matters.
+
+	The parabola goes through (-1, a), (0, b) and (1, c). On log power it is
+	exact for a gaussian main lobe and a close fit for the usual windows.
+*/
+namespace PeakInterpolation
+{
+	// --- value of the parabola at offset, offset 0 is the middle bin
+	inline float parabolicValue(float a, float b, float c, float offset)
+	{
+		return b + 0.5f * offset * ((c - a) + offset * (a - 2.0f * b + c));
+	}
+
+	// --- offset of the vertex, within -0.5..0.5 when b is a local maximum
+	inline float parabolicOffset(float a, float b, float c)
+	{
+		auto denominator = a - 2.0f * b + c;
+		return denominator < 0.0f ? 0.5f * (a - c) / denominator : 0.0f;
+	}
+
+	// --- offset from the larger neighbour's share of the magnitude, exact for the lobe of the rectangular window
+	inline float ratioOffset(float a, float b, float c)
+	{
+		if (c > a)
+		{
+			return b + c > 0.0f ? c / (b + c) : 0.0f;
+		}
+		return b + a > 0.0f ? -a / (b + a) : 0.0f;
+	}
+
+	// --- power between bins from the parabola through the log power of the three nearest bins
+	inline float interpolatePower(const float* power, int numBins, float position)
+	{
+		if (numBins < 3)
+		{
+			return power[0];
+		}
+
+		auto k = (int)(position + 0.5f);
+		k = k < 1 ? 1 : (k > numBins - 2 ? numBins - 2 : k);
+
+		// --- floor keeps the log finite for silent bins, far below anything shown
+		const float floor = 1.0e-30f;
+		auto a = logf(power[k - 1] + floor);
+		auto b = logf(power[k] + floor);
+		auto c = logf(power[k + 1] + floor);
+		return expf(parabolicValue(a, b, c, position - (float)k));
+	}
+}
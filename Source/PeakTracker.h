@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    PeakTracker.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+
+#include "PeakInterpolation.h"
+#include "SpectrumKernels.h"
+#include "WindowTable.h"
+
+enum PeakInterpolationType
+{
+	// --- parabola on log power, exact for a gaussian lobe and within 0.02 bin for the tapered windows
+	kPeakGaussian = 1,
+	// --- neighbour magnitude ratio, the parabolas are off by up to 0.2 bin on the rectangular window's lobe
+	kPeakRatio
+};
+
+struct SpectralPeak
+{
+	// --- fractional bin, 0 is dc
+	float bin = 0.0f;
+	// --- power of the bin corrected for the scalloping loss at the refined position
+	float power = 0.0f;
+};
+
+//==============================================================================
+/**
+	Finds the strongest local maxima of a power spectrum and refines them.
+
+	One pass over the bins: a vector compare of every bin against both
+	neighbours and the current acceptance level rejects whole blocks at once,
+	only blocks holding a candidate drop to scalar code. The candidates live in
+	a short sorted list, and once it is full the weakest one is the acceptance
+	level, so the pass stays O(N) however many local maxima the noise has.
+
+	Each survivor is refined from its two neighbours, a parabola on log power
+	(the quadratic that fits the tapered windows best) or the magnitude ratio
+	for the rectangular window, and its level is divided by the window's response at the refined offset, so a tone
+	halfway between bins reads the same as a bin-centred one.
+*/
+class PeakTracker
+{
+public:
+	static constexpr int maxNumPeaks = 16;
+
+	PeakTracker()
+	{
+		mNumPeaks = 0;
+		mNumFound = 0;
+		mWindowTag = 0;
+		mInterpolation = kPeakGaussian;
+		mFloor = 0.0f;
+	};
+
+	~PeakTracker()
+	{
+	};
+
+	void createPeakTracker(int numPeaks);
+	// --- picks the interpolation and rebuilds the scalloping table, free when the window is unchanged
+	void setWindow(int tag);
+
+	// --- returns the number found, at most numPeaks, strongest first; binRatio is windowSize / fftSize
+	int findPeaks(const float* power, int numBins, float binRatio, float threshold);
+	const SpectralPeak& getPeak(int index) const { return mPeaks[index]; }
+	int getInterpolation() const { return mInterpolation; }
+
+private:
+	void considerBin(const float* power, int k);
+	float getScallopingGain(float offset) const;
+
+	// --- response sampled every 1/64 bin from 0 to half a bin
+	static constexpr int numScallopingPoints = 33;
+
+	SpectralPeak mPeaks[maxNumPeaks];
+	int mBins[maxNumPeaks] = {};
+	float mScalloping[numScallopingPoints] = {};
+	int mNumPeaks;
+	int mNumFound;
+	int mWindowTag;
+	int mInterpolation;
+	float mFloor;
+};
+
+inline void PeakTracker::createPeakTracker(int numPeaks)
+{
+	mNumPeaks = numPeaks < 1 ? 1 : (numPeaks > maxNumPeaks ? maxNumPeaks : numPeaks);
+	mNumFound = 0;
+}
+
+inline void PeakTracker::setWindow(int tag)
+{
+	if (tag == mWindowTag)
+	{
+		return;
+	}
+
+	mWindowTag = tag;
+	mInterpolation = tag == kRectangular ? kPeakRatio : kPeakGaussian;
+
+	for (int i = 0; i < numScallopingPoints; i++)
+	{
+		auto offset = 0.5 * i / (numScallopingPoints - 1);
+		mScalloping[i] = (float)WindowTable::getScallopingGain(tag, offset);
+	}
+}
+
+inline float PeakTracker::getScallopingGain(float offset) const
+{
+	auto position = fabsf(offset) * 2.0f * (numScallopingPoints - 1);
+	if (position >= (float)(numScallopingPoints - 1))
+	{
+		return mScalloping[numScallopingPoints - 1];
+	}
+
+	auto i = (int)position;
+	auto frac = position - (float)i;
+	return mScalloping[i] + frac * (mScalloping[i + 1] - mScalloping[i]);
+}
+
+inline void PeakTracker::considerBin(const float* power, int k)
+{
+	auto p = power[k];
+	if (!(p > mFloor && p > power[k - 1] && p >= power[k + 1]))
+	{
+		return;
+	}
+
+	// --- insertion into the sorted list, the weakest falls off the end when it is full
+	auto i = mNumFound < mNumPeaks ? mNumFound++ : mNumPeaks - 1;
+	while (i > 0 && mPeaks[i - 1].power < p)
+	{
+		mPeaks[i] = mPeaks[i - 1];
+		mBins[i] = mBins[i - 1];
+		i--;
+	}
+	mPeaks[i].power = p;
+	mBins[i] = k;
+
+	if (mNumFound == mNumPeaks)
+	{
+		mFloor = mPeaks[mNumPeaks - 1].power;
+	}
+}
+
+inline int PeakTracker::findPeaks(const float* power, int numBins, float binRatio, float threshold)
+{
+	mNumFound = 0;
+	mFloor = threshold;
+	if (mNumPeaks == 0 || numBins < 3)
+	{
+		return 0;
+	}
+
+	// --- dc and nyquist have only one neighbour and are never reported
+	auto end = numBins - 1;
+	int k = 1;
+
+#if SPECTRUM_KERNELS_AVX2
+	for (; k + 8 <= end; k += 8)
+	{
+		auto c = _mm256_loadu_ps(power + k);
+		auto m = _mm256_and_ps(_mm256_cmp_ps(c, _mm256_loadu_ps(power + k - 1), _CMP_GT_OQ),
+			_mm256_cmp_ps(c, _mm256_loadu_ps(power + k + 1), _CMP_GE_OQ));
+		m = _mm256_and_ps(m, _mm256_cmp_ps(c, _mm256_set1_ps(mFloor), _CMP_GT_OQ));
+		if (_mm256_movemask_ps(m) != 0)
+		{
+			for (int j = 0; j < 8; j++)
+				considerBin(power, k + j);
+		}
+	}
+#elif SPECTRUM_KERNELS_SSE2
+	for (; k + 4 <= end; k += 4)
+	{
+		auto c = _mm_loadu_ps(power + k);
+		auto m = _mm_and_ps(_mm_cmpgt_ps(c, _mm_loadu_ps(power + k - 1)), _mm_cmpge_ps(c, _mm_loadu_ps(power + k + 1)));
+		m = _mm_and_ps(m, _mm_cmpgt_ps(c, _mm_set1_ps(mFloor)));
+		if (_mm_movemask_ps(m) != 0)
+		{
+			for (int j = 0; j < 4; j++)
+				considerBin(power, k + j);
+		}
+	}
+#elif SPECTRUM_KERNELS_NEON
+	for (; k + 4 <= end; k += 4)
+	{
+		auto c = vld1q_f32(power + k);
+		auto m = vandq_u32(vcgtq_f32(c, vld1q_f32(power + k - 1)), vcgeq_f32(c, vld1q_f32(power + k + 1)));
+		m = vandq_u32(m, vcgtq_f32(c, vdupq_n_f32(mFloor)));
+		if (vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(m)), 0) != 0)
+		{
+			for (int j = 0; j < 4; j++)
+				considerBin(power, k + j);
+		}
+	}
+#endif
+
+	for (; k < end; k++)
+	{
+		considerBin(power, k);
+	}
+
+	for (int i = 0; i < mNumFound; i++)
+	{
+		auto bin = mBins[i];
+		float offset;
+		// --- the ratio assumes neighbours a whole window bin away, padded bins are closer and the parabola fits them
+		if (mInterpolation == kPeakRatio && binRatio >= 1.0f)
+		{
+			offset = PeakInterpolation::ratioOffset(sqrtf(power[bin - 1]), sqrtf(power[bin]), sqrtf(power[bin + 1]));
+		}
+		else
+		{
+			// --- floor keeps the log finite next to a silent bin
+			const float floor = 1.0e-30f;
+			offset = PeakInterpolation::parabolicOffset(logf(power[bin - 1] + floor), logf(power[bin] + floor), logf(power[bin + 1] + floor));
+		}
+		offset = offset < -0.5f ? -0.5f : (offset > 0.5f ? 0.5f : offset);
+
+		// --- the table is in bins of the window, zero padding makes the transform bins narrower
+		auto gain = getScallopingGain(offset * binRatio);
+		mPeaks[i].bin = (float)bin + offset;
+		mPeaks[i].power = power[bin] / (gain * gain);
+	}
+
+	// --- the correction can swap two close candidates
+	for (int i = 1; i < mNumFound; i++)
+	{
+		auto peak = mPeaks[i];
+		auto j = i;
+		for (; j > 0 && mPeaks[j - 1].power < peak.power; j--)
+			mPeaks[j] = mPeaks[j - 1];
+		mPeaks[j] = peak;
+	}
+
+	return mNumFound;
+}
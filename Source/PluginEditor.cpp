@@ -9,6 +9,23 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// --- bands offered for the sliding DFT, high 0 runs up to nyquist
+static const struct
+{
+	const char* name;
+	float low;
+	float high;
+} slidingBands[] =
+{
+	{ "20 - 200 Hz", 20.0f, 200.0f },
+	{ "200 Hz - 2 kHz", 200.0f, 2000.0f },
+	{ "1 - 4 kHz", 1000.0f, 4000.0f },
+	{ "2 - 8 kHz", 2000.0f, 8000.0f },
+	{ "8 - 20 kHz", 8000.0f, 20000.0f },
+	{ "Full", 0.0f, 0.0f },
+};
+static constexpr int numSlidingBands = (int)(sizeof(slidingBands) / sizeof(slidingBands[0]));
+
 //==============================================================================
 puannhiAudioProcessorEditor::puannhiAudioProcessorEditor (puannhiAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
@@ -16,18 +33,33 @@ puannhiAudioProcessorEditor::puannhiAudioProcessorEditor (puannhiAudioProcessor&
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
 
-    setSize (800, 450);
+    setSize (1480, 450);
 	startTimerHz(25);
 
 	// specific private member for analysis
 	mindB = -100.0f;
 	maxdB = 0.0f;
-	max = -100.0f;
 	ratio = 20;
+	timerMilliseconds = 0.0;
+	paintMilliseconds = 0.0;
 
 	// change skew to 1.0f to get linear scale
 	skew = 1.0f; 
 	isLog = false;
+	bandsPerOctave = 0;
+	isWaterfall = false;
+	decimateToPixels = false;
+	aggregationMode = kAggregateMax;
+	backgroundIsLog = false;
+	backgroundBandsPerOctave = 0;
+	backgroundIsWaterfall = false;
+	backgroundSampleRate = 0.0;
+	takeNewestFrameOnly = false;
+	averageAxisWidth = 0;
+	averageAxisSkew = 0.0f;
+	averageAxisBandsPerOctave = 0;
+	averageAxisSampleRate = 0.0;
+	sourceListChannels = 0;
 
 	// init look and feel
 	lnf.reset(new UI_LookAndFeel);
@@ -54,13 +86,17 @@ puannhiAudioProcessorEditor::puannhiAudioProcessorEditor (puannhiAudioProcessor&
 	CwinFunc.addItem("Hamming",  3);
 	CwinFunc.addItem("Blackman", 4);
 	CwinFunc.addItem("Triangle", 5);
+	CwinFunc.addItem("Kaiser", 6);
+	CwinFunc.addItem("Flat Top", 7);
+	CwinFunc.addItem("Blackman-Harris", 8);
+	CwinFunc.addItem("Gaussian", 9);
 	CwinFunc.setSelectedItemIndex(0, true);
 	CwinFunc.setLookAndFeel(lnf.get());
 	// should place in editor side
 	CwinFunc.onChange = [this] {audioProcessor.WindowTag = CwinFunc.getSelectedId(); };
 	addAndMakeVisible(CwinFunc);
 
-	Lpeak.setText("Peak Decibel", juce::dontSendNotification);
+	Lpeak.setText("Peak Hold", juce::dontSendNotification);
 	Lpeak.setLookAndFeel(lnf.get());
 	addAndMakeVisible(Lpeak);
 
@@ -68,43 +104,371 @@ puannhiAudioProcessorEditor::puannhiAudioProcessorEditor (puannhiAudioProcessor&
 	LpeakVal.setLookAndFeel(lnf.get());
 	addAndMakeVisible(LpeakVal);
 
-	LfftSize.setText("Transform Size", juce::dontSendNotification);
+	LpeakFreq.setLookAndFeel(lnf.get());
+	addAndMakeVisible(LpeakFreq);
+
+	LfftSize.setText("Window Size", juce::dontSendNotification);
 	LfftSize.setLookAndFeel(lnf.get());
 	addAndMakeVisible(LfftSize);
 
-	LfftSizeVal.setText(juce::String(audioProcessor.N), juce::dontSendNotification);
-	LfftSizeVal.setLookAndFeel(lnf.get());
-	addAndMakeVisible(LfftSizeVal);
+	for (int order = audioProcessor.minFFTOrder; order <= audioProcessor.maxFFTOrder; order++)
+	{
+		CfftSize.addItem(juce::String(1 << order), order);
+	}
+	CfftSize.setSelectedId(audioProcessor.getFFTOrder(), juce::dontSendNotification);
+	CfftSize.setLookAndFeel(lnf.get());
+	CfftSize.onChange = [this] {audioProcessor.setFFTOrder(CfftSize.getSelectedId()); };
+	addAndMakeVisible(CfftSize);
 
-	LxScale.setText("Logarithmic", juce::dontSendNotification);
+	LxScale.setText("Frequency Scale", juce::dontSendNotification);
 	LxScale.setLookAndFeel(lnf.get());
 	addAndMakeVisible(LxScale);
 
-	BxScale.setLookAndFeel(lnf.get());
-	BxScale.onStateChange = [this] {isLog = BxScale.getToggleState(); };
-	BxScale.setClickingTogglesState(true);
-	addAndMakeVisible(BxScale);
+	CxScale.addItem("Linear", 1);
+	CxScale.addItem("Logarithmic", 2);
+	// constant-Q bands, logarithmic by construction
+	CxScale.addItem("1/3 Octave", 3);
+	CxScale.addItem("1/6 Octave", 4);
+	CxScale.addItem("1/12 Octave", 5);
+	CxScale.addItem("1/24 Octave", 6);
+	CxScale.setSelectedId(1, juce::dontSendNotification);
+	CxScale.setLookAndFeel(lnf.get());
+	CxScale.onChange = [this]
+	{
+		const int bands[] = { 0, 0, 3, 6, 12, 24 };
+		auto id = juce::jlimit(1, 6, CxScale.getSelectedId());
+		isLog = id > 1;
+		skew = id == 2 ? 0.3f : 1.0f;
+		bandsPerOctave = bands[id - 1];
+	};
+	addAndMakeVisible(CxScale);
+
+	Ldecimate.setText("Pixel Trace", juce::dontSendNotification);
+	Ldecimate.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Ldecimate);
+
+	Bdecimate.setLookAndFeel(lnf.get());
+	Bdecimate.onStateChange = [this] {decimateToPixels = Bdecimate.getToggleState(); };
+	Bdecimate.setClickingTogglesState(true);
+	addAndMakeVisible(Bdecimate);
+
+	Laggregate.setText("Bin Mapping", juce::dontSendNotification);
+	Laggregate.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Laggregate);
+
+	Caggregate.addItem("Max", kAggregateMax);
+	Caggregate.addItem("Mean", kAggregateMean);
+	Caggregate.addItem("RMS", kAggregateRMS);
+	Caggregate.addItem("Parabolic", kAggregateInterpolate);
+	Caggregate.setSelectedId(aggregationMode, juce::dontSendNotification);
+	Caggregate.setLookAndFeel(lnf.get());
+	Caggregate.onChange = [this] {aggregationMode = Caggregate.getSelectedId(); };
+	addAndMakeVisible(Caggregate);
+
+	Lwaterfall.setText("Spectrogram", juce::dontSendNotification);
+	Lwaterfall.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lwaterfall);
+
+	Bwaterfall.setLookAndFeel(lnf.get());
+	Bwaterfall.onStateChange = [this] {isWaterfall = Bwaterfall.getToggleState(); };
+	Bwaterfall.setClickingTogglesState(true);
+	addAndMakeVisible(Bwaterfall);
+
+	LuiTime.setLookAndFeel(lnf.get());
+	addAndMakeVisible(LuiTime);
+
+	Llatency.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Llatency);
+
+	Loverruns.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Loverruns);
+
+	Ldropped.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Ldropped);
+
+	Lpool.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lpool);
+
+	Loverlap.setText("Overlap", juce::dontSendNotification);
+	Loverlap.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Loverlap);
+
+	Coverlap.addItem("0%",    1);
+	Coverlap.addItem("50%",   2);
+	Coverlap.addItem("75%",   3);
+	Coverlap.addItem("87.5%", 4);
+	Coverlap.setSelectedId(audioProcessor.OverlapTag, juce::dontSendNotification);
+	Coverlap.setLookAndFeel(lnf.get());
+	Coverlap.onChange = [this] {audioProcessor.OverlapTag = Coverlap.getSelectedId(); };
+	addAndMakeVisible(Coverlap);
+
+	Lsource.setText("Channel", juce::dontSendNotification);
+	Lsource.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lsource);
+
+	updateSourceList();
+	Csource.setLookAndFeel(lnf.get());
+	Csource.onChange = [this] {audioProcessor.SourceTag = Csource.getSelectedId(); };
+	addAndMakeVisible(Csource);
+
+	Lpadding.setText("Padding", juce::dontSendNotification);
+	Lpadding.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lpadding);
+
+	// transform is the window size times the padding factor, the extra bins are zero padded
+	Cpadding.addItem("None", 1);
+	Cpadding.addItem("2x", 2);
+	Cpadding.addItem("4x", 3);
+	Cpadding.addItem("8x", 4);
+	Cpadding.setSelectedId(audioProcessor.getZeroPadding() + 1, juce::dontSendNotification);
+	Cpadding.setLookAndFeel(lnf.get());
+	Cpadding.onChange = [this] {audioProcessor.setZeroPadding(Cpadding.getSelectedId() - 1); };
+	addAndMakeVisible(Cpadding);
+
+	Llayers.setText("Layers", juce::dontSendNotification);
+	Llayers.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Llayers);
+
+	// window size alone, or stitched with windows of 1/4 and 1/16 of it for the mids and highs
+	Clayers.addItem("1", 1);
+	Clayers.addItem("2", 2);
+	Clayers.addItem("3", 3);
+	Clayers.setSelectedId(audioProcessor.getNumLayers(), juce::dontSendNotification);
+	Clayers.setLookAndFeel(lnf.get());
+	Clayers.onChange = [this] {audioProcessor.setNumLayers(Clayers.getSelectedId()); };
+	addAndMakeVisible(Clayers);
+
+	Lsliding.setText("Sliding DFT", juce::dontSendNotification);
+	Lsliding.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lsliding);
+
+	// per-sample spectrum of a band, overlaid on the line graph
+	slidingPower.assign(audioProcessor.maxSlidingBins, 0.0f);
+	Bsliding.setToggleState(audioProcessor.isSlidingEnabled(), juce::dontSendNotification);
+	Bsliding.setLookAndFeel(lnf.get());
+	Bsliding.onStateChange = [this] {audioProcessor.setSlidingEnabled(Bsliding.getToggleState()); };
+	Bsliding.setClickingTogglesState(true);
+	addAndMakeVisible(Bsliding);
+
+	LslidingBand.setText("SDFT band", juce::dontSendNotification);
+	LslidingBand.setLookAndFeel(lnf.get());
+	addAndMakeVisible(LslidingBand);
+
+	// --- every item id is one past its index in slidingBands, the last one runs up to nyquist
+	for (int i = 0; i < numSlidingBands; i++)
+	{
+		CslidingBand.addItem(slidingBands[i].name, i + 1);
+		if (slidingBands[i].low == audioProcessor.getSlidingLow() && slidingBands[i].high == audioProcessor.getSlidingHigh())
+			CslidingBand.setSelectedId(i + 1, juce::dontSendNotification);
+	}
+	CslidingBand.setLookAndFeel(lnf.get());
+	CslidingBand.onChange = [this] {updateSlidingBand(); };
+	addAndMakeVisible(CslidingBand);
+
+	LslidingLength.setText("SDFT length", juce::dontSendNotification);
+	LslidingLength.setLookAndFeel(lnf.get());
+	addAndMakeVisible(LslidingLength);
+
+	for (int order = audioProcessor.minSlidingOrder; order <= audioProcessor.maxSlidingOrder; order++)
+	{
+		CslidingLength.addItem(juce::String(1 << order), order);
+	}
+	CslidingLength.setSelectedId(audioProcessor.getSlidingOrder(), juce::dontSendNotification);
+	CslidingLength.setLookAndFeel(lnf.get());
+	CslidingLength.onChange = [this] {updateSlidingBand(); };
+	addAndMakeVisible(CslidingLength);
+
+	Laverage.setText("Average", juce::dontSendNotification);
+	Laverage.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Laverage);
+
+	// long-term average drawn over the line graph, linear is welch's estimate over the overlapped frames
+	Caverage.addItem("Off", 1);
+	Caverage.addItem("Linear", 2);
+	Caverage.addItem("Exp 1 s", 3);
+	Caverage.addItem("Exp 10 s", 4);
+	Caverage.addItem("Exp 60 s", 5);
+	Caverage.addItem("Peak", 6);
+	// the processor keeps averaging while the editor is closed, a new editor picks up its mode
+	static const int modes[] = { 0, kAverageLinear, kAverageExponential, kAverageExponential, kAverageExponential, kAveragePeakHold };
+	static const double timeConstants[] = { 10.0, 10.0, 1.0, 10.0, 60.0, 10.0 };
+	Caverage.setSelectedId(1, juce::dontSendNotification);
+	for (int i = 0; i < 6; i++)
+	{
+		if (modes[i] == audioProcessor.getAverageMode() && (modes[i] != kAverageExponential || timeConstants[i] == audioProcessor.getAverageTimeConstant()))
+		{
+			Caverage.setSelectedId(i + 1, juce::dontSendNotification);
+			break;
+		}
+	}
+	Caverage.setLookAndFeel(lnf.get());
+	Caverage.onChange = [this]
+	{
+		auto id = juce::jlimit(1, 6, Caverage.getSelectedId());
+		audioProcessor.setAverageMode(modes[id - 1], timeConstants[id - 1]);
+	};
+	addAndMakeVisible(Caverage);
+
+	BaverageReset.setButtonText("Reset");
+	BaverageReset.setLookAndFeel(lnf.get());
+	BaverageReset.onClick = [this] {audioProcessor.resetAverage(); };
+	addAndMakeVisible(BaverageReset);
+
+	LaverageTime.setLookAndFeel(lnf.get());
+	addAndMakeVisible(LaverageTime);
+
+	Lnewest.setText("Newest only", juce::dontSendNotification);
+	Lnewest.setLookAndFeel(lnf.get());
+	addAndMakeVisible(Lnewest);
+
+	// the worker skips whatever piled up and smooths only the newest frame, the skipped ones count as dropped
+	Bnewest.setLookAndFeel(lnf.get());
+	Bnewest.onStateChange = [this] {takeNewestFrameOnly = Bnewest.getToggleState(); };
+	Bnewest.setClickingTogglesState(true);
+	addAndMakeVisible(Bnewest);
 }
 
 puannhiAudioProcessorEditor::~puannhiAudioProcessorEditor()
 {
+	// the worker belongs to the processor and keeps reading, with nothing to draw it only keeps up with the frames
+	DisplaySettings settings;
+	settings.sampleRate = audioProcessor.getSampleRate();
+	audioProcessor.getAnalysisWorker().setSettings(settings);
+
 	CwinFunc.setLookAndFeel(nullptr);
 	LwinFunc.setLookAndFeel(nullptr);
 	Sratio.setLookAndFeel(nullptr);
 	Lratio.setLookAndFeel(nullptr);
 	Lpeak.setLookAndFeel(nullptr);
 	LpeakVal.setLookAndFeel(nullptr);
+	LpeakFreq.setLookAndFeel(nullptr);
 	LfftSize.setLookAndFeel(nullptr);
-	LfftSizeVal.setLookAndFeel(nullptr);
-	BxScale.setLookAndFeel(nullptr);
+	CfftSize.setLookAndFeel(nullptr);
+	CxScale.setLookAndFeel(nullptr);
 	LxScale.setLookAndFeel(nullptr);
+	Bwaterfall.setLookAndFeel(nullptr);
+	Lwaterfall.setLookAndFeel(nullptr);
+	Bdecimate.setLookAndFeel(nullptr);
+	Ldecimate.setLookAndFeel(nullptr);
+	Caggregate.setLookAndFeel(nullptr);
+	Laggregate.setLookAndFeel(nullptr);
+	LuiTime.setLookAndFeel(nullptr);
+	Llatency.setLookAndFeel(nullptr);
+	Loverruns.setLookAndFeel(nullptr);
+	Ldropped.setLookAndFeel(nullptr);
+	Lpool.setLookAndFeel(nullptr);
+	Loverlap.setLookAndFeel(nullptr);
+	Coverlap.setLookAndFeel(nullptr);
+	Lsource.setLookAndFeel(nullptr);
+	Csource.setLookAndFeel(nullptr);
+	Lpadding.setLookAndFeel(nullptr);
+	Cpadding.setLookAndFeel(nullptr);
+	Llayers.setLookAndFeel(nullptr);
+	Clayers.setLookAndFeel(nullptr);
+	Lsliding.setLookAndFeel(nullptr);
+	Bsliding.setLookAndFeel(nullptr);
+	LslidingBand.setLookAndFeel(nullptr);
+	CslidingBand.setLookAndFeel(nullptr);
+	LslidingLength.setLookAndFeel(nullptr);
+	CslidingLength.setLookAndFeel(nullptr);
+	Laverage.setLookAndFeel(nullptr);
+	Caverage.setLookAndFeel(nullptr);
+	BaverageReset.setLookAndFeel(nullptr);
+	LaverageTime.setLookAndFeel(nullptr);
+	Lnewest.setLookAndFeel(nullptr);
+	Bnewest.setLookAndFeel(nullptr);
+}
+
+void puannhiAudioProcessorEditor::updateSlidingBand()
+{
+	// --- a band set from elsewhere has no item, it stays as it is when only the length changes
+	auto index = CslidingBand.getSelectedId() - 1;
+	auto low = index >= 0 ? slidingBands[index].low : audioProcessor.getSlidingLow();
+	auto high = index >= 0 ? slidingBands[index].high : audioProcessor.getSlidingHigh();
+	audioProcessor.setSlidingBand(CslidingLength.getSelectedId(), low, high);
+}
+
+void puannhiAudioProcessorEditor::updateSourceList()
+{
+	// the list follows the bus layout, channels are named after their speaker or ambisonic component
+	auto layout = audioProcessor.getChannelLayoutOfBus(true, 0);
+	auto numChannels = juce::jmin(audioProcessor.getTotalNumInputChannels(), audioProcessor.maxNumChannels);
+	sourceListChannels = audioProcessor.getTotalNumInputChannels();
+
+	Csource.clear(juce::dontSendNotification);
+	Csource.addItem("All", kSourceAll);
+	if (numChannels >= 2)
+	{
+		Csource.addItem("Mid", kSourceMid);
+		Csource.addItem("Side", kSourceSide);
+	}
+	for (int channel = 0; channel < numChannels; channel++)
+	{
+		auto name = juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(channel));
+		Csource.addItem(name.isEmpty() ? juce::String(channel + 1) : name, kSourceChannel + channel);
+	}
+
+	if (Csource.indexOfItemId(audioProcessor.SourceTag) < 0)
+	{
+		audioProcessor.SourceTag = kSourceAll;
+	}
+	Csource.setSelectedId(audioProcessor.SourceTag, juce::dontSendNotification);
 }
 
 //==============================================================================
 void puannhiAudioProcessorEditor::paint (juce::Graphics& g)
 {
-	drawFrame(g);
-	drawCoordiante(g);
+	auto startTicks = juce::Time::getHighResolutionTicks();
+
+	// grid only changes with the layout, the scale mode or the sample rate
+	auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	if (!backgroundImage.isValid()
+		|| backgroundImage.getWidth() != juce::roundToInt(getWidth() * scale)
+		|| backgroundIsLog != isLog
+		|| backgroundBandsPerOctave != bandsPerOctave
+		|| backgroundIsWaterfall != isWaterfall
+		|| backgroundSampleRate != audioProcessor.getSampleRate())
+	{
+		renderBackground(scale);
+	}
+
+	if (isWaterfall)
+	{
+		spectrogram.draw(g, (int)offset_x, (int)offset_y);
+	}
+	else
+	{
+		drawFrame(g);
+	}
+
+	g.setOpacity(1.0f);
+	g.drawImage(backgroundImage, getLocalBounds().toFloat());
+
+	paintMilliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+void puannhiAudioProcessorEditor::renderBackground(float scale)
+{
+	backgroundIsLog = isLog;
+	backgroundBandsPerOctave = bandsPerOctave;
+	backgroundIsWaterfall = isWaterfall;
+	backgroundSampleRate = audioProcessor.getSampleRate();
+
+	auto width = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+	auto height = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+	backgroundImage = juce::Image(juce::Image::ARGB, width, height, true);
+
+	juce::Graphics g(backgroundImage);
+	g.addTransform(juce::AffineTransform::scale(scale));
+
+	if (isWaterfall)
+	{
+		drawSpectrogramFrequency(g);
+	}
+	else
+	{
+		drawCoordiante(g);
+	}
 }
 
 void puannhiAudioProcessorEditor::resized()
@@ -123,14 +487,48 @@ void puannhiAudioProcessorEditor::resized()
 	CwinFunc.setBounds(160, row1, 250, 25);
 	Lpeak.setBounds(420, row1, 100, 25);
 	LpeakVal.setBounds(520, row1, 80, 25);
+	Ldecimate.setBounds(620, row1, 100, 25);
+	Bdecimate.setBounds(715, row1, 25, 25);
 
 	Lratio.setBounds(40, row2, 120, 25);
 	Sratio.setBounds(160, row2, 250, 25);
 	LfftSize.setBounds(420, row2, 100, 25);
-	LfftSizeVal.setBounds(520, row2, 80, 25);
+	CfftSize.setBounds(520, row2, 80, 25);
+	Laggregate.setBounds(620, row2, 70, 25);
+	Caggregate.setBounds(690, row2, 70, 25);
 
 	LxScale.setBounds(40, row3, 120, 25);
-	BxScale.setBounds(155, row3, 25, 25);
+	CxScale.setBounds(160, row3, 110, 25);
+	Lwaterfall.setBounds(280, row3, 100, 25);
+	Bwaterfall.setBounds(375, row3, 25, 25);
+	Loverlap.setBounds(420, row3, 100, 25);
+	Coverlap.setBounds(520, row3, 80, 25);
+	LuiTime.setBounds(620, row3, 140, 25);
+
+	Lsource.setBounds(780, row1, 60, 25);
+	Csource.setBounds(840, row1, 70, 25);
+	Lpadding.setBounds(780, row2, 60, 25);
+	Cpadding.setBounds(840, row2, 70, 25);
+	LpeakFreq.setBounds(780, row3, 130, 25);
+
+	Llayers.setBounds(920, row1, 80, 25);
+	Clayers.setBounds(1000, row1, 70, 25);
+	Llatency.setBounds(1080, row1, 75, 25);
+	Lsliding.setBounds(920, row2, 80, 25);
+	Bsliding.setBounds(1000, row2, 25, 25);
+	LslidingBand.setBounds(1160, row1, 80, 25);
+	CslidingBand.setBounds(1240, row1, 110, 25);
+	LslidingLength.setBounds(1160, row2, 80, 25);
+	CslidingLength.setBounds(1240, row2, 110, 25);
+	LaverageTime.setBounds(1080, row2, 70, 25);
+	Laverage.setBounds(920, row3, 80, 25);
+	Caverage.setBounds(1000, row3, 70, 25);
+	BaverageReset.setBounds(1080, row3, 70, 25);
+	Lnewest.setBounds(1160, row3, 80, 25);
+	Bnewest.setBounds(1240, row3, 25, 25);
+	Loverruns.setBounds(1360, row1, 110, 25);
+	Ldropped.setBounds(1360, row2, 110, 25);
+	Lpool.setBounds(1360, row3, 110, 25);
 
 	width_f = SpectrogramArea.getWidth();
 	height_f = SpectrogramArea.getHeight();
@@ -143,76 +541,273 @@ void puannhiAudioProcessorEditor::resized()
 
 	lineGridSize = width_f / (float)audioProcessor.lineScopeSize;
 	barGridSize = width_f / (float)audioProcessor.barScopeSize;
+
+	// layout changed, grid is rendered again on the next paint
+	backgroundImage = juce::Image();
+
+	// worst case is a min/max pair per pixel, the path picks up the new layout with the next frame
+	pixelMin.assign(juce::jmax(0, width_i), 0.0f);
+	pixelMax.assign(juce::jmax(0, width_i), 0.0f);
+	spectrumPath.preallocateSpace(3 * (2 * width_i + audioProcessor.lineScopeSize));
+	averagePath.preallocateSpace(3 * (width_i + audioProcessor.lineScopeSize));
+	barRects.ensureStorageAllocated(audioProcessor.barScopeSize);
+
+	// one column per frame, history length is the width of the graph area
+	spectrogram.createImage(width_i, height_i);
+	spectrogramColumn.assign(juce::jmax(0, height_i), 0.0f);
 }
 
 
 void puannhiAudioProcessorEditor::timerCallback()
 {
-	if (audioProcessor.nextBlockReady = true)
-	{		
+	auto startTicks = juce::Time::getHighResolutionTicks();
+
+	// the host changed the bus layout while the editor was open
+	if (audioProcessor.getTotalNumInputChannels() != sourceListChannels)
+	{
+		updateSourceList();
+	}
+
+	DisplaySettings settings;
+	settings.numLinePoints = decimateToPixels ? width_i : audioProcessor.lineScopeSize;
+	settings.decimateToPixels = decimateToPixels;
+	settings.numBars = audioProcessor.barScopeSize;
+	settings.numRows = (int)spectrogramColumn.size();
+	settings.skew = skew;
+	settings.bandsPerOctave = bandsPerOctave;
+	settings.aggregationMode = aggregationMode;
+	settings.ratio = ratio;
+	settings.mindB = mindB;
+	settings.maxdB = maxdB;
+	settings.sampleRate = audioProcessor.getSampleRate();
+	settings.takeNewestFrameOnly = takeNewestFrameOnly;
+	audioProcessor.getAnalysisWorker().setSettings(settings);
+
+	auto needsRepaint = false;
+
+	// spectrogram columns arrive ready to draw, one per analysed frame
+	auto numRows = (int)spectrogramColumn.size();
+	while (numRows > 0 && audioProcessor.getAnalysisWorker().popColumn(spectrogramColumn.data(), numRows))
+	{
+		spectrogram.pushColumn(spectrogramColumn.data());
+		needsRepaint = true;
+	}
+
+	if (audioProcessor.getAnalysisWorker().getLatestFrame(displayFrame))
+	{
 		drawNextFrameOfSpectrum();
-		audioProcessor.nextBlockReady = false;
+		needsRepaint = true;
+	}
+
+	// published every few samples, every tick picks up the newest
+	if (audioProcessor.isSlidingEnabled() || !slidingPath.isEmpty())
+	{
+		updateSlidingPath();
+		needsRepaint = true;
+	}
+
+	// the processor's long-term average, a snapshot every tick while it runs
+	if (audioProcessor.getAverageMode() > 0 || !averagePath.isEmpty())
+	{
+		updateAveragePath();
+		needsRepaint = true;
+	}
+
+	if (needsRepaint)
+	{
 		repaint();
 	}
+
+	timerMilliseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+	LuiTime.setText("UI " + juce::String(timerMilliseconds + paintMilliseconds, 2) + " ms", juce::dontSendNotification);
+	// --- the last frame's delay against the most any frame may take before it is given up
+	Llatency.setText("Lag " + juce::String(juce::roundToInt(audioProcessor.getLastFrameLatency() * 1000.0)) + "/"
+		+ juce::String(juce::roundToInt(audioProcessor.getFrameLatencyBound() * 1000.0)) + " ms", juce::dontSendNotification);
+	// --- frames the audio thread could not queue, and queued ones the worker skipped to stay on the newest
+	Loverruns.setText("Lost " + juce::String(audioProcessor.spectrumFifo.getOverrunCount()), juce::dontSendNotification);
+	Ldropped.setText("Skipped " + juce::String(audioProcessor.spectrumFifo.getDroppedCount()), juce::dontSendNotification);
+	// --- frames the pool had no slot for, already part of Lost, and frames it finished past the budget that went out empty
+	Lpool.setText("Busy " + juce::String(audioProcessor.getPoolSkippedCount()) + " Late "
+		+ juce::String(audioProcessor.getPoolExpiredCount()), juce::dontSendNotification);
 }
 
 void puannhiAudioProcessorEditor::drawNextFrameOfSpectrum()
 {	
-	if (isLog)
+	// worker output is already aggregated and in display units, only copy it over
+	if (decimateToPixels)
 	{
-		skew = 0.3f;
+		if (displayFrame.line.size() == pixelMax.size() && displayFrame.lineMin.size() == pixelMin.size())
+		{
+			std::copy(displayFrame.line.begin(), displayFrame.line.end(), pixelMax.begin());
+			std::copy(displayFrame.lineMin.begin(), displayFrame.lineMin.end(), pixelMin.begin());
+		}
 	}
-	else
+	else if ((int)displayFrame.line.size() == audioProcessor.lineScopeSize)
 	{
-		skew = 1.0f;
+		std::copy(displayFrame.line.begin(), displayFrame.line.end(), audioProcessor.lineScopeData);
 	}
 
-	for (int i = 0; i < audioProcessor.N; i++)
+	if ((int)displayFrame.bars.size() == audioProcessor.barScopeSize)
 	{
-		// to compensate the data outside nyquist
-		auto amplitude = std::abs(audioProcessor.OutputArray[i]) * 2;
-		//auto angle = std::arg(audioProcessor.frameProcessArray[i]);
-		audioProcessor.currentOutputArray[i] = amplitude;
-		audioProcessor.previousOutputArray[i] = (ratio / 100.0f) * audioProcessor.currentOutputArray[i] + (1.0f - (ratio / 100.0f)) * audioProcessor.previousOutputArray[i];
+		std::copy(displayFrame.bars.begin(), displayFrame.bars.end(), audioProcessor.barScopeData);
 	}
 
-	// convert data disribution from linear into logarithm
-	// for line graph
-	for (int i = 0; i < audioProcessor.lineScopeSize; i++)
-	{
-		auto skewedProportionX = 1.0f - std::exp(std::log(1.0f - (float)i / (float)audioProcessor.lineScopeSize) * skew);
-		auto fftDataIndex = juce::jlimit(0, audioProcessor.N / 2, (int)(skewedProportionX * (float)audioProcessor.N * 0.5f));
+	updateFramePath();
 
-		auto Ve = juce::Decibels::gainToDecibels(audioProcessor.previousOutputArray[fftDataIndex]);
-		auto V0 = juce::Decibels::gainToDecibels((float)audioProcessor.N);
+	// strongest interpolated peak, held and decaying on the worker
+	auto& peak = displayFrame.peakHold;
+	LpeakVal.setText(juce::String(peak.level, 1) + " dB", juce::dontSendNotification);
+	if (peak.level > mindB)
+		LpeakFreq.setText(juce::String(peak.frequency, 1) + " Hz", juce::dontSendNotification);
+	else
+		LpeakFreq.setText("", juce::dontSendNotification);
+}
 
-		auto level_limited = juce::jlimit(mindB, maxdB, Ve-V0);
-		
-		auto level = juce::jmap(level_limited, mindB, maxdB, 0.0f, 1.0f);
-		
-		audioProcessor.lineScopeData[i] = level;
+void puannhiAudioProcessorEditor::updateFramePath()
+{
+	spectrumPath.clear();
 
-		if (level_limited > max)
+	// line graph
+	if (decimateToPixels)
+	{
+		// vertical min/max span per pixel column
+		for (int x = 0; x < (int)pixelMax.size(); x++)
 		{
-			max = level_limited;
+			auto x_pos = offset_x + (float)x;
+			auto y_max = offset_y + juce::jmap(pixelMax[x], 0.0f, 1.0f, height_f, 0.0f);
+			auto y_min = offset_y + juce::jmap(pixelMin[x], 0.0f, 1.0f, height_f, 0.0f);
+
+			if (x == 0)
+				spectrumPath.startNewSubPath(x_pos, y_max);
+			else
+				spectrumPath.lineTo(x_pos, y_max);
+
+			if (y_min != y_max)
+				spectrumPath.lineTo(x_pos, y_min);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < audioProcessor.lineScopeSize; i++)
+		{
+			auto x_pos = offset_x + (float)juce::jmap(i, 0, audioProcessor.lineScopeSize - 1, 0, width_i);
+			auto y_pos = offset_y + juce::jmap(audioProcessor.lineScopeData[i], 0.0f, 1.0f, height_f, 0.0f);
+
+			if (i == 0)
+				spectrumPath.startNewSubPath(x_pos, y_pos);
+			else
+				spectrumPath.lineTo(x_pos, y_pos);
 		}
 	}
 
-	// convert data disribution from linear into logarithm
-	// for bar graph
+	// bar graph
+	barRects.clearQuick();
 	for (int i = 0; i < audioProcessor.barScopeSize; i++)
 	{
-		auto skewedProportionX = 1.0f - std::exp(std::log(1.0f - (float)i / (float)audioProcessor.barScopeSize) * skew);
-		auto fftDataIndex = juce::jlimit(0, audioProcessor.N / 2, (int)(skewedProportionX * (float)audioProcessor.N * 0.5f));
+		auto val = juce::jmap(audioProcessor.barScopeData[i], 0.0f, 1.0f, 0.0f, height_f);
+		auto rect = juce::Rectangle<float>(offset_x + i * barGridSize, offset_y + (height_f - val), barGridSize, height_f - (height_f - val));
+		rect.reduce(2, 0);
+		barRects.addWithoutMerging(rect);
+	}
+}
+
+void puannhiAudioProcessorEditor::updateAveragePath()
+{
+	averagePath.clear();
+	auto sampleRate = audioProcessor.getSampleRate();
+	if (!audioProcessor.getAverageSnapshot(averageSnapshot) || averageSnapshot.noiseBandwidth <= 0.0 || sampleRate <= 0.0 || width_i <= 0)
+	{
+		LaverageTime.setText("", juce::dontSendNotification);
+		return;
+	}
 
-		auto Ve = juce::Decibels::gainToDecibels(audioProcessor.previousOutputArray[fftDataIndex]);
-		auto V0 = juce::Decibels::gainToDecibels((float)audioProcessor.N);
+	// input time the long-term average covers so far
+	LaverageTime.setText(juce::String(averageSnapshot.seconds, 1) + " s", juce::dontSendNotification);
 
-		auto level_limited = juce::jlimit(mindB, maxdB, Ve - V0);
+	// pixel column of every bin on the current axis, -1 off the axis, only worked out again when the axis changes
+	auto numBins = (int)averageSnapshot.density.size();
+	if (numBins != (int)averageBinColumn.size() || width_i != averageAxisWidth || skew != averageAxisSkew
+		|| bandsPerOctave != averageAxisBandsPerOctave || sampleRate != averageAxisSampleRate)
+	{
+		averageBinColumn.resize(numBins);
+		for (int k = 0; k < numBins; k++)
+		{
+			auto proportion = inverse_x((float)(k * sampleRate / averageSnapshot.fftSize));
+			averageBinColumn[k] = proportion < 0.0f || proportion > 1.0f ? -1 : juce::jmin(width_i - 1, (int)(proportion * width_f));
+		}
+		averageAxisWidth = width_i;
+		averageAxisSkew = skew;
+		averageAxisBandsPerOctave = bandsPerOctave;
+		averageAxisSampleRate = sampleRate;
+	}
 
-		auto level = juce::jmap(level_limited, mindB, maxdB, 0.0f, 1.0f);
+	// density is per Hz, shown as the level the newest window gives it so it lines up with the trace,
+	// bins sharing a column are combined like the line, the mean modes average the density
+	auto useMean = aggregationMode == kAggregateMean || aggregationMode == kAggregateRMS;
+	averageColumns.assign(width_i, 0.0f);
+	averageColumnBins.assign(width_i, 0);
+	for (int k = 0; k < numBins; k++)
+	{
+		auto x = averageBinColumn[k];
+		if (x < 0)
+			continue;
+
+		auto density = averageSnapshot.density[k];
+		averageColumns[x] = useMean ? averageColumns[x] + density : juce::jmax(averageColumns[x], density);
+		averageColumnBins[x]++;
+	}
 
-		audioProcessor.barScopeData[i] = level;
+	auto toPower = (float)(2.0 * averageSnapshot.noiseBandwidth);
+	auto isFirstPoint = true;
+	for (int x = 0; x < width_i; x++)
+	{
+		if (averageColumnBins[x] == 0)
+			continue;
+
+		auto density = useMean ? averageColumns[x] / (float)averageColumnBins[x] : averageColumns[x];
+		auto level = 10.0f * std::log10(juce::jmax(density * toPower, 1.0e-20f));
+		auto x_pos = offset_x + (float)x;
+		auto y_pos = offset_y + juce::jmap(juce::jlimit(mindB, maxdB, level), mindB, maxdB, height_f, 0.0f);
+
+		if (isFirstPoint)
+			averagePath.startNewSubPath(x_pos, y_pos);
+		else
+			averagePath.lineTo(x_pos, y_pos);
+		isFirstPoint = false;
+	}
+}
+
+void puannhiAudioProcessorEditor::updateSlidingPath()
+{
+	slidingPath.clear();
+	if (!audioProcessor.isSlidingEnabled())
+		return;
+
+	int firstBin = 0;
+	int fftSize = 0;
+	auto numBins = audioProcessor.getSlidingPower(slidingPower.data(), (int)slidingPower.size(), firstBin, fftSize);
+	auto sampleRate = audioProcessor.getSampleRate();
+	if (numBins == 0 || fftSize == 0 || sampleRate <= 0.0)
+		return;
+
+	// same full scale reference as the frames, a bin-centred full scale sine reads 0 dB
+	auto V0 = juce::Decibels::gainToDecibels((float)fftSize * SlidingDFT::coherentGain);
+	auto isFirstPoint = true;
+	for (int i = 0; i < numBins; i++)
+	{
+		auto proportion = inverse_x((float)((firstBin + i) * sampleRate / fftSize));
+		if (proportion < 0.0f || proportion > 1.0f)
+			continue;
+
+		auto level = 10.0f * std::log10(juce::jmax(slidingPower[i], 1.0e-20f)) - V0;
+		auto x_pos = offset_x + proportion * width_f;
+		auto y_pos = offset_y + juce::jmap(juce::jlimit(mindB, maxdB, level), mindB, maxdB, height_f, 0.0f);
+
+		if (isFirstPoint)
+			slidingPath.startNewSubPath(x_pos, y_pos);
+		else
+			slidingPath.lineTo(x_pos, y_pos);
+		isFirstPoint = false;
 	}
 }
 
@@ -221,35 +816,23 @@ void puannhiAudioProcessorEditor::drawFrame(juce::Graphics& g)
 	g.setColour(juce::Colours::grey);
 	g.fillRect(offset_x, offset_y, width_f, height_f);
 
-	// line graph
-	for (int i = 1; i < audioProcessor.lineScopeSize; i++)
-	{
-		g.setColour(juce::Colours::antiquewhite);
-		g.drawLine({ 
-			offset_x + (float)juce::jmap(i - 1, 0, audioProcessor.lineScopeSize - 1, 0, width_i),
-			offset_y + juce::jmap(audioProcessor.lineScopeData[i - 1], 0.0f, 1.0f, height_f, 0.0f),
-			offset_x + (float)juce::jmap(i,     0, audioProcessor.lineScopeSize - 1, 0, width_i),
-			offset_y + juce::jmap(audioProcessor.lineScopeData[i],     0.0f, 1.0f, height_f, 0.0f)
-			});
-	}
+	// whole trace and all bars go through the renderer once each
+	g.setColour(juce::Colours::antiquewhite);
+	g.strokePath(spectrumPath, juce::PathStrokeType(1.0f));
 
-	// bar graph
-	for (int i = 0; i < audioProcessor.barScopeSize; i++)
-	{
-		g.setColour(juce::Colours::greenyellow);
-		auto val = juce::jmap(audioProcessor.barScopeData[i], 0.0f, 1.0f, 0.0f, height_f);
-		auto rect = juce::Rectangle<float>(offset_x + i * barGridSize, offset_y + (height_f - val), barGridSize, height_f - (height_f - val));
-		rect.reduce(2, 0);
-		g.fillRect(rect);
-	}
+	g.setColour(juce::Colours::greenyellow);
+	g.fillRectList(barRects);
+
+	g.setColour(juce::Colours::coral);
+	g.strokePath(slidingPath, juce::PathStrokeType(1.0f));
 
-	// display decibel
-	LpeakVal.setText(juce::String(max), juce::dontSendNotification);
+	g.setColour(juce::Colours::deepskyblue);
+	g.strokePath(averagePath, juce::PathStrokeType(1.5f));
 }
 
 void puannhiAudioProcessorEditor::drawCoordiante(juce::Graphics & g)
 {
-	// should be driven by gui event?
+	// only runs when the cached background is rebuilt
 	drawAmplitude(g);
 	drawFrequency(g);
 }
@@ -321,6 +904,30 @@ void puannhiAudioProcessorEditor::drawFrequency(juce::Graphics& g)
 }
 
 
+void puannhiAudioProcessorEditor::drawSpectrogramFrequency(juce::Graphics& g)
+{
+	// frequency runs bottom to top in the spectrogram, time left to right
+	g.setColour(juce::Colours::antiquewhite.withAlpha(0.7f));
+	g.setFont(g.getCurrentFont().withHeight(10.0f));
+
+	int k_iter = 1 + audioProcessor.getSampleRate() / 2000;
+	if (isLog)
+	{
+		k_iter = 21;
+	}
+
+	for (int i = 1; i < k_iter; i++)
+	{
+		auto frequency = i * 1000.0f;
+		float y_pos = offset_y + height_f - inverse_x(frequency) * height_f;
+
+		if (i < 11 || i == 12 || i == 15 || i == 20)
+		{
+			g.drawHorizontalLine(int(y_pos), offset_x - 4, offset_x);
+			g.drawText(juce::String(i) + juce::String("k"), offset_x - 40, int(y_pos) - 12, 32, 25, juce::Justification::right, false);
+		}
+	}
+}
 
 void puannhiAudioProcessorEditor::unit_test(juce::Graphics& g)
 {
@@ -346,7 +953,9 @@ void puannhiAudioProcessorEditor::unit_test(juce::Graphics& g)
 
 float puannhiAudioProcessorEditor::inverse_x(float frequency)
 {
-	auto fftDataIndex = frequency * audioProcessor.N / audioProcessor.getSampleRate();
-	auto skewedProportionX = fftDataIndex * 2 / audioProcessor.N;
-	return 1 - std::powf(1 - skewedProportionX, 1 / skew);
+	if (bandsPerOctave > 0)
+	{
+		return ConstantQKernel::frequencyToProportion(frequency, bandsPerOctave, audioProcessor.getSampleRate());
+	}
+	return FrequencyAxis::frequencyToProportion(frequency, audioProcessor.getSampleRate(), skew);
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrogramImage.h"
+#include "SpectrumAnalysisWorker.h"
 
 class UI_LookAndFeel : public juce::LookAndFeel_V4
 {
@@ -93,10 +95,18 @@ public:
 
 	void unit_test(juce::Graphics& g);
 	void drawNextFrameOfSpectrum();
+	void updateFramePath();
+	void updateSlidingPath();
+	void updateAveragePath();
 	void drawFrame(juce::Graphics& g);
 	void drawCoordiante(juce::Graphics& g);
+	void renderBackground(float scale);
 	void drawFrequency(juce::Graphics& g);
+	void drawSpectrogramFrequency(juce::Graphics& g);
 	void drawAmplitude(juce::Graphics& g);
+	void updateSourceList();
+	// hands the band and length combos to the processor
+	void updateSlidingBand();
 
 	float inverse_x(float freq);
 
@@ -110,12 +120,55 @@ public:
 	
 	juce::Label Lpeak;
 	juce::Label LpeakVal;
+	juce::Label LpeakFreq;
 
 	juce::Label LfftSize;
-	juce::Label LfftSizeVal;
+	juce::ComboBox CfftSize;
 
 	juce::Label LxScale;
-	juce::ToggleButton BxScale;
+	juce::ComboBox CxScale;
+
+	juce::Label Ldecimate;
+	juce::ToggleButton Bdecimate;
+
+	juce::Label Laggregate;
+	juce::ComboBox Caggregate;
+
+	juce::Label Lwaterfall;
+	juce::ToggleButton Bwaterfall;
+
+	juce::Label Loverlap;
+	juce::ComboBox Coverlap;
+
+	juce::Label Lsource;
+	juce::ComboBox Csource;
+
+	juce::Label Lpadding;
+	juce::ComboBox Cpadding;
+
+	juce::Label Llayers;
+	juce::ComboBox Clayers;
+
+	juce::Label Lsliding;
+	juce::ToggleButton Bsliding;
+	juce::Label LslidingBand;
+	juce::ComboBox CslidingBand;
+	juce::Label LslidingLength;
+	juce::ComboBox CslidingLength;
+
+	juce::Label Laverage;
+	juce::ComboBox Caverage;
+	juce::TextButton BaverageReset;
+	juce::Label LaverageTime;
+
+	juce::Label Lnewest;
+	juce::ToggleButton Bnewest;
+
+	juce::Label LuiTime;
+	juce::Label Llatency;
+	juce::Label Loverruns;
+	juce::Label Ldropped;
+	juce::Label Lpool;
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -123,10 +176,22 @@ private:
 
 	float mindB;
 	float maxdB;
-	float max;
 	float skew;
 	float ratio;
 	bool isLog;
+	// --- 0 for the FFT bins, otherwise constant-Q bands per octave
+	int bandsPerOctave;
+	bool isWaterfall;
+	// trace one min/max pair per pixel column instead of lineScopeSize points
+	bool decimateToPixels;
+	int aggregationMode;
+	// false: every queued frame goes through the smoothing, true: only the newest one is used
+	bool takeNewestFrameOnly;
+	// input channel count the channel list was built for
+	int sourceListChannels;
+	// message thread cost of the last timer callback and paint
+	double timerMilliseconds;
+	double paintMilliseconds;
 	float width_f;
 	float height_f;
 	int width_i;
@@ -136,6 +201,40 @@ private:
 	float lineGridSize;
 	float barGridSize;
 
+	// --- grid, ticks and labels, rendered once and blitted over the data each paint
+	juce::Image backgroundImage;
+	bool backgroundIsLog;
+	int backgroundBandsPerOctave;
+	bool backgroundIsWaterfall;
+	double backgroundSampleRate;
+
+	// --- reused every frame, clear() keeps their storage
+	juce::Path spectrumPath;
+	juce::Path averagePath;
+	juce::RectangleList<float> barRects;
+	std::vector<float> pixelMin;
+	std::vector<float> pixelMax;
+
+	// --- snapshot of the processor's long-term average and where its bins land on the axis
+	SpectrumAverageSnapshot averageSnapshot;
+	std::vector<int> averageBinColumn;
+	std::vector<float> averageColumns;
+	std::vector<int> averageColumnBins;
+	int averageAxisWidth;
+	float averageAxisSkew;
+	int averageAxisBandsPerOctave;
+	double averageAxisSampleRate;
+
+	// --- band of the sliding DFT drawn over the line graph, read straight from the processor
+	juce::Path slidingPath;
+	std::vector<float> slidingPower;
+
+	// --- latest output of the processor's analysis worker
+	DisplayFrame displayFrame;
+
+	SpectrogramImage spectrogram;
+	std::vector<float> spectrogramColumn;
+
 	std::unique_ptr<UI_LookAndFeel> lnf;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (puannhiAudioProcessorEditor)
@@ -22,16 +22,20 @@ puannhiAudioProcessor::puannhiAudioProcessor()
                        )
 #endif
 {
-
+	analysisWorker.onLongestFrame = [this](const SpectrumFrame& frame) { addToAverage(frame); };
+	startTimerHz(10);
 }
 
 puannhiAudioProcessor::~puannhiAudioProcessor()
 {
-	delete[] InputArray;
-	delete[] OutputArray;
+	stopTimer();
+	analysisWorker.stopThread(1000);
+	analysisPool.releasePool();
 	delete[] lineScopeData;
-	delete[] previousOutputArray;
-	delete[] currentOutputArray;
+	delete pendingLayout.exchange(nullptr);
+	delete retiredLayout.exchange(nullptr);
+	delete pendingSliding.exchange(nullptr);
+	delete retiredSliding.exchange(nullptr);
 }
 
 //==============================================================================
@@ -99,18 +103,63 @@ void puannhiAudioProcessor::changeProgramName (int index, const juce::String& ne
 //==============================================================================
 void puannhiAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-	forwardFFT = new juce::dsp::FFT(log2(N));
+	// audio is stopped here, so the layout can be built in place once the workers are gone,
+	// the fifo's reader goes too, it would otherwise keep reading frames that are about to be freed
+	analysisWorker.stopThread(1000);
+	analysisPool.releasePool();
+	delete pendingLayout.exchange(nullptr);
+	delete retiredLayout.exchange(nullptr);
+	activeLayout.reset(createLayout());
 	input_sample_rate = sampleRate;
 
-	circularbuffer.createCircularBuffer(N);
-	circularbuffer.flushBuffer();
+	// bins depend on the sample rate, the band is rebuilt here too
+	delete pendingSliding.exchange(nullptr);
+	delete retiredSliding.exchange(nullptr);
+	activeSliding.reset(createSlidingDFT(sampleRate));
+	slidingScratch.assign(maxSlidingBins, 0.0f);
+	slidingIsRunning = false;
+	slidingNumBins.store(0);
+
+	// rings and fifo are sized for the largest transform so a size change never reallocates them,
+	// mirrored, so every analysis window is one contiguous run of samples
+	auto numChannels = juce::jlimit(1, maxNumChannels, getTotalNumInputChannels());
+	channelBuffers.clear();
+	for (int channel = 0; channel < numChannels; channel++)
+	{
+		channelBuffers.add(new CircularBuffer<float>())->createCircularBuffer(ringLength, true);
+	}
+	midBuffer.createCircularBuffer(ringLength, true);
+	sideBuffer.createCircularBuffer(ringLength, true);
+	derivedBuffer.setSize(2, juce::jmax(1, samplesPerBlock));
+
+	// a frame carries one half spectrum per analysed channel, the reader starts again on the new frames
+	spectrumFifo.createFifo(numQueuedFrames, maxNumBins * numChannels);
+
+	// the longest transform's bins, the estimate starts again at the new rate
+	{
+		const juce::ScopedLock sl(averageLock);
+		spectrumAverage.createSpectrumAverage(maxNumBins);
+		averageDensity.assign(maxNumBins, 0.0f);
+		averageSourceDensity.assign(maxNumBins, 0.0f);
+		averageFFTSize = 0;
+		averagePosition = -1;
+	}
+	analysisWorker.startThread();
+
+	// one thread is kept free for the audio and the editor
+	latencyBudget = (juce::int64)(sampleRate * latencyBudgetSeconds);
+	frameLatencyBound.store((double)(latencyBudget + samplesPerBlock) / sampleRate, std::memory_order_relaxed);
+	lastFrameLatency.store(0.0, std::memory_order_relaxed);
+	analysisPool.createPool(juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1), numQueuedFrames, 1 << maxFFTOrder);
+
+	loadTags();
 
-	//juce::zeromem(OutputArray, sizeof(std::complex<float>)*N);
-	juce::zeromem(previousOutputArray, sizeof(float)*N);
-	for (int i = 0; i < N; i++)
+	// first frames are taken once the buffer holds a full window of fresh samples
+	for (int layer = 0; layer < activeLayout->numLayers; layer++)
 	{
-		previousOutputArray[i] = juce::Decibels::gainToDecibels(previousOutputArray[i] / (N / 1));
+		samplesUntilNextFrame[layer] = activeLayout->layers[0]->windowSize + getStagger(layer);
 	}
+	samplesWritten = 0;
 
 	for (int i = 0; i < lineScopeSize; i++)
 	{
@@ -127,6 +176,167 @@ void puannhiAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+	analysisWorker.stopThread(1000);
+	delete retiredLayout.exchange(nullptr);
+	delete retiredSliding.exchange(nullptr);
+}
+
+void puannhiAudioProcessor::timerCallback()
+{
+	// the audio thread only swaps again once these are collected, a retired layout also holds the
+	// plans and window tables of a transform size nobody uses any more
+	delete retiredLayout.exchange(nullptr);
+	delete retiredSliding.exchange(nullptr);
+}
+
+void puannhiAudioProcessor::setFFTOrder(int order)
+{
+	order = juce::jlimit(minFFTOrder, maxFFTOrder, order);
+	requestedFFTOrder = order;
+
+	// the audio thread only retires a layout once the previous one has been collected here
+	delete retiredLayout.exchange(nullptr);
+	delete pendingLayout.exchange(createLayout());
+}
+
+void puannhiAudioProcessor::setZeroPadding(int paddingOrder)
+{
+	requestedPaddingOrder = juce::jlimit(0, maxPaddingOrder, paddingOrder);
+
+	delete retiredLayout.exchange(nullptr);
+	delete pendingLayout.exchange(createLayout());
+}
+
+void puannhiAudioProcessor::setNumLayers(int numLayers)
+{
+	requestedNumLayers = juce::jlimit(1, maxNumLayers, numLayers);
+
+	delete retiredLayout.exchange(nullptr);
+	delete pendingLayout.exchange(createLayout());
+}
+
+void puannhiAudioProcessor::setSlidingEnabled(bool enabled)
+{
+	slidingEnabled = enabled;
+}
+
+void puannhiAudioProcessor::setSlidingBand(int order, float lowFrequency, float highFrequency)
+{
+	requestedSlidingOrder = juce::jlimit(minSlidingOrder, maxSlidingOrder, order);
+	requestedSlidingLow = juce::jmax(0.0f, lowFrequency);
+	requestedSlidingHigh = highFrequency;
+
+	delete retiredSliding.exchange(nullptr);
+	delete pendingSliding.exchange(createSlidingDFT(getSampleRate()));
+}
+
+int puannhiAudioProcessor::getSlidingPower(float* power, int maxBins, int& firstBin, int& fftSize) const
+{
+	// a band change between these loads only mixes two updates for one read
+	auto numBins = juce::jmin(maxBins, slidingNumBins.load(std::memory_order_acquire));
+	firstBin = slidingFirstBin.load(std::memory_order_relaxed);
+	fftSize = slidingSize.load(std::memory_order_relaxed);
+	for (int i = 0; i < numBins; i++)
+	{
+		power[i] = slidingPower[i].load(std::memory_order_relaxed);
+	}
+	return numBins;
+}
+
+void puannhiAudioProcessor::setAverageMode(int mode, double timeConstant)
+{
+	averageTimeConstant = timeConstant;
+	averageMode = mode;
+}
+
+void puannhiAudioProcessor::resetAverage()
+{
+	const juce::ScopedLock sl(averageLock);
+	spectrumAverage.reset();
+}
+
+bool puannhiAudioProcessor::getAverageSnapshot(SpectrumAverageSnapshot& destination)
+{
+	const juce::ScopedLock sl(averageLock);
+
+	// vectors keep their capacity, so this only allocates when the transform grows
+	destination.density.resize(spectrumAverage.getNumValues());
+	if (averageMode.load() <= 0 || !spectrumAverage.getSnapshot(destination.density.data()))
+	{
+		return false;
+	}
+
+	destination.fftSize = averageFFTSize;
+	destination.sampleRate = input_sample_rate;
+	destination.noiseBandwidth = averageNoiseBandwidth;
+	destination.seconds = spectrumAverage.getSeconds();
+	return true;
+}
+
+void puannhiAudioProcessor::addToAverage(const SpectrumFrame& frame)
+{
+	const juce::ScopedLock sl(averageLock);
+
+	// switching it off discards the average, switching it on again starts from scratch
+	auto mode = averageMode.load();
+	if (mode <= 0 || input_sample_rate <= 0.0)
+	{
+		spectrumAverage.reset();
+		return;
+	}
+
+	// density does not depend on the window, so a new window or zero padding of the same
+	// transform size keeps averaging, one half spectrum per source is summed and divided
+	// by the window's noise bandwidth, 2 |X|^2 / (fs * sum(w^2)) for the one sided spectrum
+	auto numBins = juce::jmin(frame.numBins, (int)averageDensity.size());
+	auto numSources = juce::jmax(1, frame.numSources);
+	auto windowSize = frame.windowSize > 0 ? frame.windowSize : frame.fftSize;
+	auto sumOfSquares = (double)frame.enbw * frame.coherentGain * frame.coherentGain * windowSize;
+	auto scale = (float)(2.0 / (input_sample_rate * sumOfSquares * numSources));
+
+	SpectrumKernels::squaredMagnitude(frame.bins.get(), averageDensity.data(), numBins, scale);
+	for (int source = 1; source < numSources; source++)
+	{
+		SpectrumKernels::squaredMagnitude(frame.bins.get() + source * frame.numBins, averageSourceDensity.data(), numBins, scale);
+		juce::FloatVectorOperations::add(averageDensity.data(), averageSourceDensity.data(), numBins);
+	}
+
+	// first frame or a restarted transport, there is no interval to count
+	auto frameSeconds = averagePosition >= 0 && frame.samplePosition > averagePosition
+		? (double)(frame.samplePosition - averagePosition) / input_sample_rate : 0.0;
+	averagePosition = frame.samplePosition;
+	averageFFTSize = frame.fftSize;
+	averageNoiseBandwidth = frame.enbw * input_sample_rate / windowSize;
+
+	spectrumAverage.addFrame(averageDensity.data(), numBins, mode, averageTimeConstant.load(), frameSeconds);
+}
+
+SlidingDFT* puannhiAudioProcessor::createSlidingDFT(double sampleRate)
+{
+	// before prepareToPlay the rate is unknown, the band is built again once it is
+	auto order = requestedSlidingOrder.load();
+	auto size = 1 << order;
+	auto binWidth = (sampleRate > 0.0 ? sampleRate : 44100.0) / size;
+	auto low = requestedSlidingLow.load();
+	auto high = requestedSlidingHigh.load();
+
+	auto firstBin = juce::jlimit(0, size / 2, (int)(low / binWidth));
+	auto lastBin = high > low ? juce::jlimit(firstBin, size / 2, (int)std::ceil(high / binWidth)) : size / 2;
+
+	// every input channel gets its own sums, the source decides how many are fed, never more than the inputs
+	auto numFed = juce::jlimit(1, maxNumChannels, getTotalNumInputChannels());
+	auto maxBins = juce::jmin(maxSlidingBins, maxSlidingBinsPerSample / numFed);
+
+	auto* sliding = new SlidingDFT();
+	sliding->createSlidingDFT(maxNumChannels, order, firstBin, juce::jmin(maxBins, lastBin - firstBin + 1));
+	return sliding;
+}
+
+AnalysisLayout* puannhiAudioProcessor::createLayout()
+{
+	// padding stops at the largest transform, a 65536 window is never padded
+	return new AnalysisLayout(requestedFFTOrder.load(), requestedPaddingOrder.load(), requestedNumLayers.load(),
+		minFFTOrder, maxFFTOrder, *fftPlans);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -136,21 +346,12 @@ bool puannhiAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-   // if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-   //  && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-   //     return false;
-
-   // // This checks if the input layout matches the output layout
-   //#if ! JucePlugin_IsSynth
-   // if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-   //     return false;
-   //#endif
+	// any layout up to maxNumChannels, the audio passes straight through
+	auto input = layouts.getMainInputChannelSet();
+	if (input.isDisabled() || input.size() > maxNumChannels)
+		return false;
 
-    return true;
+	return layouts.getMainOutputChannelSet() == input;
   #endif
 }
 #endif
@@ -163,66 +364,275 @@ void puannhiAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-	auto channelDataL = buffer.getWritePointer(0);
-	auto channelDataR = buffer.getWritePointer(1);
+	// frames the workers are done with go to the editor in the order they were queued
+	collectFrames();
+	loadTags();
 
-	for (auto i = 0; i < buffer.getNumSamples(); ++i)
+	// pick up a layout built by setFFTOrder, the old one is freed on the message thread,
+	// but only once no queued frame uses it any more
+	auto layoutIsWaiting = pendingLayout.load(std::memory_order_relaxed) != nullptr
+		&& retiredLayout.load(std::memory_order_acquire) == nullptr;
+	if (layoutIsWaiting && analysisPool.isIdle())
 	{
-		//auto data = (channelDataL[i] + channelDataR[i]) * 0.5;
-		auto data = (channelDataL[i]);
-		circularbuffer.writeBuffer(data);
+		if (auto* nextLayout = pendingLayout.exchange(nullptr, std::memory_order_acq_rel))
+		{
+			retiredLayout.store(activeLayout.release(), std::memory_order_release);
+			activeLayout.reset(nextLayout);
+			layoutIsWaiting = false;
+
+			for (int layer = 0; layer < activeLayout->numLayers; layer++)
+			{
+				samplesUntilNextFrame[layer] = getHopSize(layer) + getStagger(layer);
+			}
+		}
 	}
 
-	if (WindowTag == 1)
+	// a band from setSlidingBand, no queued frame refers to it so there is nothing to drain
+	if (retiredSliding.load(std::memory_order_acquire) == nullptr)
 	{
-		for (int i = 0; i < N; i++)
+		if (auto* nextSliding = pendingSliding.exchange(nullptr, std::memory_order_acq_rel))
 		{
-			InputArray[i] = circularbuffer.readBuffer(N - i);
+			retiredSliding.store(activeSliding.release(), std::memory_order_release);
+			activeSliding.reset(nextSliding);
+			slidingIsRunning = false;
 		}
 	}
-	else if(WindowTag == 2)
+
+	// sums are stale after it was off or fed from another source, they fill up again from silence
+	auto slidingIsEnabled = slidingEnabled.load(std::memory_order_relaxed) && activeSliding != nullptr;
+	if (slidingIsEnabled && (!slidingIsRunning || slidingSourceTag != blockSourceTag))
 	{
-		for (int i = 0; i < N; i++)
-		{
-			InputArray[i] = (circularbuffer.readBuffer(N - i))*0.5*(1 - cos(2 * M_PI*i / (N - 1)));
+		activeSliding->reset();
+		slidingSourceTag = blockSourceTag;
+		samplesUntilSlidingUpdate = slidingUpdateInterval;
+	}
+	slidingIsRunning = slidingIsEnabled;
 
-		}
+	auto numSamples = buffer.getNumSamples();
+	auto numLayers = activeLayout->numLayers;
+
+	// a frame is due every hop, regardless of how the host slices the audio
+	for (int layer = 0; layer < numLayers; layer++)
+	{
+		samplesUntilNextFrame[layer] = juce::jmin(samplesUntilNextFrame[layer], getHopSize(layer));
 	}
-	else if (WindowTag == 3)
+
+	// block is written in chunks that end exactly on frame boundaries of any layer
+	for (auto i = 0; i < numSamples;)
 	{
-		for (int i = 0; i < N; i++)
+		auto numToWrite = numSamples - i;
+		for (int layer = 0; layer < numLayers; layer++)
+		{
+			numToWrite = juce::jmin(numToWrite, samplesUntilNextFrame[layer]);
+		}
+		if (slidingIsRunning)
 		{
-			InputArray[i] = (circularbuffer.readBuffer(N - i))*(0.54-0.46*cos(2*M_PI*i/ (N - 1)));
+			numToWrite = juce::jmin(numToWrite, samplesUntilSlidingUpdate);
+		}
+
+		analysisPool.setWritePosition(samplesWritten + numToWrite);
+		writeChannels(buffer, i, numToWrite);
+		samplesWritten += numToWrite;
+		i += numToWrite;
 
+		if (slidingIsRunning)
+		{
+			processSliding(numToWrite);
+		}
+
+		for (int layer = 0; layer < numLayers; layer++)
+		{
+			samplesUntilNextFrame[layer] -= numToWrite;
+			if (samplesUntilNextFrame[layer] <= 0)
+			{
+				samplesUntilNextFrame[layer] = getHopSize(layer);
+				// frames are skipped while the pool drains for a new layout
+				if (!layoutIsWaiting)
+				{
+					queueFrame(layer);
+				}
+			}
 		}
 	}
-	else if (WindowTag == 4)
+
+	collectFrames();
+}
+
+int puannhiAudioProcessor::getHopSize(int layer) const
+{
+	return activeLayout->layers[layer]->windowSize >> (juce::jlimit(1, 4, blockOverlapTag) - 1);
+}
+
+void puannhiAudioProcessor::loadTags()
+{
+	blockWindowTag = WindowTag.load(std::memory_order_relaxed);
+	blockOverlapTag = OverlapTag.load(std::memory_order_relaxed);
+	blockSourceTag = SourceTag.load(std::memory_order_relaxed);
+}
+
+int puannhiAudioProcessor::getStagger(int layer) const
+{
+	// hops are powers of 2, a fraction of a hop never lands on another layer's boundary
+	return getHopSize(layer) * layer / activeLayout->numLayers;
+}
+
+void puannhiAudioProcessor::writeChannels(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+	auto numChannels = juce::jmin(buffer.getNumChannels(), getTotalNumInputChannels(), channelBuffers.size());
+	for (int channel = 0; channel < numChannels; channel++)
 	{
-		for (int i = 0; i < N; i++)
-		{
-			InputArray[i] = (circularbuffer.readBuffer(N - i))*(0.42 - 0.5*cos(2 * M_PI*i / (N - 1)) + 0.08*cos(4 * M_PI*i / (N - 1)));
+		channelBuffers[channel]->writeBuffer(buffer.getReadPointer(channel, startSample), numSamples);
+	}
+
+	if (numChannels < 2)
+		return;
+
+	// hosts may send more than samplesPerBlock, the derived signals go through in pieces if they do
+	auto* left = buffer.getReadPointer(0, startSample);
+	auto* right = buffer.getReadPointer(1, startSample);
+	auto* mid = derivedBuffer.getWritePointer(0);
+	auto* side = derivedBuffer.getWritePointer(1);
+	for (int i = 0; i < numSamples;)
+	{
+		auto numToWrite = juce::jmin(numSamples - i, derivedBuffer.getNumSamples());
+		juce::FloatVectorOperations::copyWithMultiply(mid, left + i, 0.5f, numToWrite);
+		juce::FloatVectorOperations::addWithMultiply(mid, right + i, 0.5f, numToWrite);
+		juce::FloatVectorOperations::copyWithMultiply(side, left + i, 0.5f, numToWrite);
+		juce::FloatVectorOperations::addWithMultiply(side, right + i, -0.5f, numToWrite);
+		midBuffer.writeBuffer(mid, numToWrite);
+		sideBuffer.writeBuffer(side, numToWrite);
+		i += numToWrite;
+	}
+}
+
+void puannhiAudioProcessor::processSliding(int numSamples)
+{
+	CircularBuffer<float>* sources[maxNumChannels];
+	auto numSources = getAnalysisSources(sources);
+	if (numSources == 0)
+		return;
+
+	// the rings are mirrored, the new samples and the ones a window before them are one run each
+	const float* input[maxNumChannels];
+	const float* delayed[maxNumChannels];
+	auto size = activeSliding->getSize();
+	for (int source = 0; source < numSources; source++)
+	{
+		input[source] = sources[source]->getContiguousBlock(numSamples, numSamples);
+		delayed[source] = sources[source]->getContiguousBlock(numSamples, numSamples + size);
+	}
+	activeSliding->process(input, delayed, numSources, numSamples);
+
+	samplesUntilSlidingUpdate -= numSamples;
+	if (samplesUntilSlidingUpdate <= 0)
+	{
+		samplesUntilSlidingUpdate = slidingUpdateInterval;
 
+		auto numBins = activeSliding->getNumBins();
+		activeSliding->getPower(slidingScratch.data(), numSources);
+		for (int i = 0; i < numBins; i++)
+		{
+			slidingPower[i].store(slidingScratch[i], std::memory_order_relaxed);
 		}
+		slidingFirstBin.store(activeSliding->getFirstBin(), std::memory_order_relaxed);
+		slidingSize.store(size, std::memory_order_relaxed);
+		slidingNumBins.store(numBins, std::memory_order_release);
 	}
-	else if (WindowTag == 5)
+}
+
+int puannhiAudioProcessor::getAnalysisSources(CircularBuffer<float>** sources)
+{
+	auto numChannels = juce::jmin(getTotalNumInputChannels(), channelBuffers.size());
+	if (numChannels <= 0)
+		return 0;
+
+	if (blockSourceTag == kSourceAll)
 	{
-		for (int i = 0; i < N; i++)
+		for (int channel = 0; channel < numChannels; channel++)
 		{
-			if (i <= N / 2)
-			{
-				InputArray[i] = (circularbuffer.readBuffer(N - i))*(2*i/ (N - 1));
-			}
-			else
-			{
-				InputArray[i] = (circularbuffer.readBuffer(N - i))*(2-2*i/(N-1));
-			}
+			sources[channel] = channelBuffers[channel];
 		}
+		return numChannels;
 	}
 
-	if (!nextBlockReady)
+	// mid and side need a pair, a channel that went away with a layout change falls back to the first one
+	if (blockSourceTag == kSourceMid && numChannels >= 2)
+		sources[0] = &midBuffer;
+	else if (blockSourceTag == kSourceSide && numChannels >= 2)
+		sources[0] = &sideBuffer;
+	else if (blockSourceTag >= kSourceChannel && blockSourceTag - kSourceChannel < numChannels)
+		sources[0] = channelBuffers[blockSourceTag - kSourceChannel];
+	else
+		sources[0] = channelBuffers[0];
+	return 1;
+}
+
+void puannhiAudioProcessor::queueFrame(int layer)
+{
+	CircularBuffer<float>* sources[maxNumChannels];
+	auto numSources = getAnalysisSources(sources);
+	if (numSources == 0)
+		return;
+
+	// workers or editor are behind, drop this frame rather than wait, the sequence still moves on
+	auto* job = analysisPool.beginJob();
+	if (job == nullptr)
 	{
-		forwardFFT->perform(InputArray, OutputArray, false);
-		nextBlockReady = true;
+		spectrumFifo.skipWrite();
+		return;
+	}
+
+	auto* frame = spectrumFifo.beginWrite();
+	if (frame == nullptr)
+		return;
+
+	auto& layout = *activeLayout;
+	auto& setup = *layout.layers[layer];
+	auto windowSize = setup.windowSize;
+	// shorter windows sit in the middle of the longest one, so every layer describes the same moment
+	auto delay = windowSize + (layout.layers[0]->windowSize - windowSize) / 2;
+
+	// only the spans are taken here, windowing and the transforms happen on the pool
+	for (int source = 0; source < numSources; source++)
+	{
+		job->spans[source] = sources[source]->getContiguousSpans(windowSize, delay);
+	}
+	job->frame = frame;
+	job->setup = &setup;
+	job->window = setup.windowTable.getWindow(blockWindowTag);
+	job->numSources = numSources;
+	// rings hold the frame until they have been written ringLength - delay further
+	job->deadline = samplesWritten + juce::jmin((juce::int64)sources[0]->getBufferLength() - delay, latencyBudget);
+
+	frame->numSources = numSources;
+	frame->numBins = setup.numBins;
+	frame->fftSize = setup.fftSize;
+	frame->windowSize = windowSize;
+	frame->windowTag = blockWindowTag;
+	frame->hopSize = getHopSize(layer);
+	frame->layer = layer;
+	frame->numLayers = layout.numLayers;
+	frame->coherentGain = setup.windowTable.getCoherentGain(blockWindowTag);
+	frame->enbw = setup.windowTable.getENBW(blockWindowTag);
+	frame->samplePosition = samplesWritten;
+	analysisPool.submitJob();
+}
+
+void puannhiAudioProcessor::collectFrames()
+{
+	while (auto* job = analysisPool.getFinishedJob())
+	{
+		// a frame that missed its deadline still has to pass through the fifo to keep the order
+		if (job->expired.load(std::memory_order_relaxed))
+		{
+			job->frame->numSources = 0;
+		}
+		else
+		{
+			lastFrameLatency.store((double)(samplesWritten - job->frame->samplePosition) / input_sample_rate, std::memory_order_relaxed);
+		}
+		spectrumFifo.finishWrite();
+		analysisPool.retireJob();
 	}
 }
 
@@ -14,11 +14,29 @@
 #include <math.h>
 
 #include "CircularBuffer.h"
+#include "AnalysisSetup.h"
+#include "SpectrumFifo.h"
+#include "AnalysisThreadPool.h"
+#include "SlidingDFT.h"
+#include "SpectrumAnalysisWorker.h"
+#include "SpectrumAverage.h"
+
+// what the analysis looks at, kSourceChannel + n picks input channel n on its own
+enum AnalysisSource
+{
+	// mean power of every input channel, a mono signal reads the same as on one channel
+	kSourceAll = 1,
+	// (L + R) / 2 and (L - R) / 2 of the first two channels
+	kSourceMid,
+	kSourceSide,
+	kSourceChannel
+};
 
 //==============================================================================
 /**
 */
-class puannhiAudioProcessor : public juce::AudioProcessor
+class puannhiAudioProcessor : public juce::AudioProcessor,
+							  private juce::Timer
 #if JucePlugin_Enable_ARA
 	, public juce::AudioProcessorARAExtension
 #endif
@@ -61,24 +79,175 @@ public:
 	void getStateInformation(juce::MemoryBlock& destData) override;
 	void setStateInformation(const void* data, int sizeInBytes) override;
 
-	int nextBlockReady = false;
-
 	const int lineScopeSize = 128;  
 	float* lineScopeData = new float[lineScopeSize];
 	const int barScopeSize = 64;
 	float* barScopeData = new float[barScopeSize];
 
-	const int N = 2048;
-	std::complex<float>* InputArray = new std::complex<float>[N];
-	std::complex<float>* OutputArray = new std::complex<float>[N];
-	CircularBuffer<float> circularbuffer;
-	float* previousOutputArray = new float[N];
-	float* currentOutputArray = new float[N];
+	// window length is 2^order, from 256 up to 65536 points, zero padding makes the transform up to 8 times longer
+	static constexpr int minFFTOrder = 8;
+	static constexpr int maxFFTOrder = 16;
+	static constexpr int maxPaddingOrder = 3;
+	static constexpr int maxNumLayers = AnalysisLayout::maxNumLayers;
+	static constexpr int maxNumBins = (1 << maxFFTOrder) / 2 + 1;
+	// 7.1.4 needs 12, third order ambisonics 16
+	static constexpr int maxNumChannels = AnalysisThreadPool::maxNumSources;
+	// twice the largest transform, the slack is how long a queued frame stays readable in the rings,
+	// shorter layers are read up to half the longest window back so all layers share a centre
+	static constexpr int ringLength = 2 << maxFFTOrder;
+	static constexpr int numQueuedFrames = 8;
+	// frames the pool has not finished this long after they were due are given up
+	static constexpr double latencyBudgetSeconds = 0.2;
+
+	// one ring per input channel, mid and side are only fed when there are at least two
+	juce::OwnedArray<CircularBuffer<float>> channelBuffers;
+	CircularBuffer<float> midBuffer;
+	CircularBuffer<float> sideBuffer;
+	// frames travel to the editor through here, the audio thread never waits on it
+	SpectrumFifo spectrumFifo;
+
+	// the fifo's only reader, it runs while the processor is prepared and the editor attaches to it
+	SpectrumAnalysisWorker& getAnalysisWorker() { return analysisWorker; }
 
 	double input_sample_rate = 0.0;
-	int WindowTag = 1;
+	// --- written by the editor, the audio thread loads each of them once per block
+	std::atomic<int> WindowTag { 1 };
+	// 1 = 0%, 2 = 50%, 3 = 75%, 4 = 87.5% overlap between consecutive frames
+	std::atomic<int> OverlapTag { 1 };
+	std::atomic<int> SourceTag { kSourceAll };
+
+	// called from the message thread, the new size is picked up at the start of the next block
+	void setFFTOrder(int order);
+	int getFFTOrder() const { return requestedFFTOrder.load(); }
+	// 0 = none, 1 = 2x, 2 = 4x, 3 = 8x the window length, same hand-over as setFFTOrder
+	void setZeroPadding(int paddingOrder);
+	int getZeroPadding() const { return requestedPaddingOrder.load(); }
+	// 1 = the selected window only, 2 and 3 add windows of a quarter and a sixteenth of its length
+	void setNumLayers(int numLayers);
+	int getNumLayers() const { return requestedNumLayers.load(); }
+
+	// sliding DFT next to the frames, a band of bins brought up to date with every input sample
+	// and published every slidingUpdateInterval samples, 0.7 ms at 48 kHz
+	static constexpr int minSlidingOrder = 6;
+	static constexpr int maxSlidingOrder = 14;
+	static constexpr int maxSlidingBins = 1024;
+	static constexpr int slidingUpdateInterval = 32;
+	// bins times channels updated on the audio thread per sample, a wider band or more channels
+	// clip the band at its top
+	static constexpr int maxSlidingBinsPerSample = 1024;
+	// 200 Hz to 2 kHz over 2048 samples, 80 bins at 48 kHz
+	static constexpr int defaultSlidingOrder = 11;
+	static constexpr float defaultSlidingLow = 200.0f;
+	static constexpr float defaultSlidingHigh = 2000.0f;
+
+	void setSlidingEnabled(bool enabled);
+	bool isSlidingEnabled() const { return slidingEnabled.load(); }
+	// window of 2^order samples over the bins from lowFrequency up to highFrequency, up to nyquist
+	// when highFrequency is not above lowFrequency, same hand-over as setFFTOrder
+	void setSlidingBand(int order, float lowFrequency, float highFrequency);
+	int getSlidingOrder() const { return requestedSlidingOrder.load(); }
+	float getSlidingLow() const { return requestedSlidingLow.load(); }
+	float getSlidingHigh() const { return requestedSlidingHigh.load(); }
+	// latest published band, returns how many bins went into power, the first is bin firstBin of an fftSize transform
+	int getSlidingPower(float* power, int maxBins, int& firstBin, int& fftSize) const;
+
+	// a frame reaches the fifo at most this long after its last sample was written, the latency
+	// budget plus the block it is collected in, later ones are given up
+	double getFrameLatencyBound() const { return frameLatencyBound.load(std::memory_order_relaxed); }
+	// how long the last delivered frame took from its last sample to the fifo, in seconds
+	double getLastFrameLatency() const { return lastFrameLatency.load(std::memory_order_relaxed); }
+	// frames the pool had no free job slot for, and frames it finished after the latency budget ran out
+	juce::uint64 getPoolSkippedCount() const { return analysisPool.getSkippedCount(); }
+	juce::uint64 getPoolExpiredCount() const { return analysisPool.getExpiredCount(); }
+
+	// long-term average of the power spectral density of the longest window, fed by the analysis
+	// worker whether an editor is open or not; mode 0 is off, otherwise a SpectrumAverageMode,
+	// the time constant is in seconds and only matters to kAverageExponential
+	void setAverageMode(int mode, double timeConstant);
+	int getAverageMode() const { return averageMode.load(); }
+	double getAverageTimeConstant() const { return averageTimeConstant.load(); }
+	void resetAverage();
+	// message thread, false while averaging is off or before its first frame
+	bool getAverageSnapshot(SpectrumAverageSnapshot& destination);
 private:
 	//==============================================================================
-	juce::ScopedPointer<juce::dsp::FFT> forwardFFT;
+	// message thread, frees the layout and sliding DFT the audio thread swapped out
+	void timerCallback() override;
+	AnalysisLayout* createLayout();
+	void queueFrame(int layer);
+	void collectFrames();
+	int getHopSize(int layer) const;
+	// takes this block's copy of the tags the editor writes
+	void loadTags();
+	// layers take their frames at staggered points of their hop, so no two are queued on the same sample
+	int getStagger(int layer) const;
+	void writeChannels(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+	SlidingDFT* createSlidingDFT(double sampleRate);
+	// feeds the samples just written to the rings through the sliding DFT
+	void processSliding(int numSamples);
+	// fills sources with the rings the source of this block asks for and returns how many there are
+	int getAnalysisSources(CircularBuffer<float>** sources);
+	// analysis worker, every frame of the longest window
+	void addToAverage(const SpectrumFrame& frame);
+
+	// --- stopped whenever the fifo is rebuilt, declared after it so it is gone first
+	SpectrumAnalysisWorker analysisWorker { spectrumFifo };
+
+	// --- sized in prepareToPlay, shared by the analysis worker and the message thread under averageLock
+	SpectrumAverage spectrumAverage;
+	juce::CriticalSection averageLock;
+	std::vector<float> averageDensity;
+	std::vector<float> averageSourceDensity;
+	int averageFFTSize = 0;
+	double averageNoiseBandwidth = 0.0;
+	juce::int64 averagePosition = -1;
+	std::atomic<int> averageMode { 0 };
+	std::atomic<double> averageTimeConstant { 10.0 };
+
+	// --- audio thread owns activeLayout, the other two only move through atomic exchanges
+	std::unique_ptr<AnalysisLayout> activeLayout;
+	std::atomic<AnalysisLayout*> pendingLayout { nullptr };
+	std::atomic<AnalysisLayout*> retiredLayout { nullptr };
+	std::atomic<int> requestedFFTOrder { 11 };
+	std::atomic<int> requestedPaddingOrder { 0 };
+	std::atomic<int> requestedNumLayers { 1 };
+	// --- keeps the benchmarked plans alive for as long as any instance is
+	juce::SharedResourcePointer<FFTPlanCache> fftPlans;
+
+	// --- same hand-over as the layouts, nothing queued refers to a sliding DFT so it is swapped right away
+	std::unique_ptr<SlidingDFT> activeSliding;
+	std::atomic<SlidingDFT*> pendingSliding { nullptr };
+	std::atomic<SlidingDFT*> retiredSliding { nullptr };
+	std::atomic<bool> slidingEnabled { false };
+	std::atomic<int> requestedSlidingOrder { defaultSlidingOrder };
+	std::atomic<float> requestedSlidingLow { defaultSlidingLow };
+	std::atomic<float> requestedSlidingHigh { defaultSlidingHigh };
+	// --- audio thread, the sums start again when it is switched on or the source changes
+	bool slidingIsRunning = false;
+	int slidingSourceTag = 0;
+	int samplesUntilSlidingUpdate = 0;
+	std::vector<float> slidingScratch;
+	// --- published band, the bin count is stored last
+	std::atomic<float> slidingPower[maxSlidingBins];
+	std::atomic<int> slidingFirstBin { 0 };
+	std::atomic<int> slidingSize { 0 };
+	std::atomic<int> slidingNumBins { 0 };
+
+	// --- the tags as loaded at the start of the block, every frame of a block agrees on them
+	int blockWindowTag = 1;
+	int blockOverlapTag = 1;
+	int blockSourceTag = kSourceAll;
+
+	// --- stft scheduler, counts input samples down to the next frame of each layer
+	int samplesUntilNextFrame[maxNumLayers] = {};
+	juce::int64 samplesWritten = 0;
+	// mid / side of the current chunk before it goes into the rings
+	juce::AudioBuffer<float> derivedBuffer;
+
+	// --- declared last, so its threads are gone before the rings and setups they read
+	AnalysisThreadPool analysisPool;
+	juce::int64 latencyBudget = 0;
+	std::atomic<double> frameLatencyBound { 0.0 };
+	std::atomic<double> lastFrameLatency { 0.0 };
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(puannhiAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    SlicedFFT.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <complex>
+#include <vector>
+
+#include "CircularBuffer.h"
+#include "FFTBackend.h"
+
+//==============================================================================
+/**
+	A real forward transform split into passes of independent slices, so one
+	large frame can be shared by several threads and no single piece of work
+	grows with the transform size.
+
+	The N real samples are packed into M = N / 2 complex points and M = P * Q is
+	done four-step (Bailey): Q transforms of length P over the points Q apart,
+	each multiplied by the twiddles W_M^(q k) and stored as a row, then P
+	transforms of length Q down the columns, in place, which leaves the M point
+	spectrum in natural order. The last pass separates the even and odd samples
+	again and gives the N / 2 + 1 bins of the real input, also in place, so the
+	frame's bin storage is the only buffer the slices share. The short row and
+	column transforms are complex plans from the FFTPlanCache, so they run on
+	whichever backend won the benchmark for their length.
+
+	Every pass has the same number of slices, each one touching about
+	pointsPerSlice points, and a pass may only start once every slice of the
+	previous one has finished. The output is unscaled, in the layout of
+	FFTBackend::performRealForward. The tables are built once per size and only
+	read afterwards.
+*/
+class SlicedFFT
+{
+public:
+	static constexpr int numPasses = 3;
+
+	SlicedFFT()
+	{
+		mOrder = 0;
+		mSize = 0;
+		mNumPoints = 0;
+		mRowOrder = 0;
+		mColumnOrder = 0;
+		mRowLength = 0;
+		mColumnLength = 0;
+		mScratchStride = 0;
+		mNumSlices = 0;
+	};
+
+	~SlicedFFT()
+	{
+	};
+
+	// --- order of the real transform, at least 4
+	void createSlicedFFT(int order, int pointsPerSlice, FFTPlanCache& plans);
+
+	int getSize() const { return mSize; }
+	int getNumSlices() const { return mNumSlices; }
+	// --- complex values of 64 byte aligned scratch one slice needs: the gathered points,
+	//     their transform and the plan's work
+	int getScratchSize() const { return 3 * mScratchStride; }
+
+	// --- pass 0 reads windowSize samples from the spans times window, the rest of the transform is zero padding
+	void performRows(int slice, const CircularBuffer<float>::Spans& spans, const float* window, int windowSize,
+		std::complex<float>* bins, std::complex<float>* scratch) const;
+	void performColumns(int slice, std::complex<float>* bins, std::complex<float>* scratch) const;
+	// --- bins holds N / 2 + 1 values, the last one is only written here
+	void performSplit(int slice, std::complex<float>* bins) const;
+
+	// --- all three passes in order on one thread
+	void performRealForward(const CircularBuffer<float>::Spans& spans, const float* window, int windowSize,
+		std::complex<float>* bins, std::complex<float>* scratch) const;
+
+private:
+	// --- length points from scratch, transformed into the second part of scratch, which is returned
+	std::complex<float>* transform(const FFTBackend& plan, std::complex<float>* scratch) const;
+
+	static inline std::complex<float> multiply(std::complex<float> a, std::complex<float> b)
+	{
+		// --- spelled out, the operator checks for infinities on every product
+		return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+	}
+
+	// --- W_M^j for j < M, applied between the row and the column transforms
+	std::vector<std::complex<float>> mTwiddles;
+	// --- W_N^k for k <= M / 2, used to separate the even and odd samples
+	std::vector<std::complex<float>> mSplitTwiddles;
+	std::shared_ptr<const FFTBackend> mRowPlan;
+	std::shared_ptr<const FFTBackend> mColumnPlan;
+	int mOrder;
+	int mSize;
+	int mNumPoints;
+	int mRowOrder;
+	int mColumnOrder;
+	int mRowLength;
+	int mColumnLength;
+	// --- the longer side rounded up to whole 64 byte lines, so every part of the scratch stays aligned
+	int mScratchStride;
+	int mNumSlices;
+};
+
+inline void SlicedFFT::createSlicedFFT(int order, int pointsPerSlice, FFTPlanCache& plans)
+{
+	mOrder = order < 4 ? 4 : order;
+	mSize = 1 << mOrder;
+	mNumPoints = mSize / 2;
+
+	// --- the shorter side along the rows, P <= Q
+	mRowOrder = (mOrder - 1) / 2;
+	mColumnOrder = mOrder - 1 - mRowOrder;
+	mRowLength = 1 << mRowOrder;
+	mColumnLength = 1 << mColumnOrder;
+	mScratchStride = ((mColumnLength + 7) / 8) * 8;
+	mRowPlan = plans.getComplexPlan(mRowOrder);
+	mColumnPlan = plans.getComplexPlan(mColumnOrder);
+
+	mNumSlices = pointsPerSlice > 0 ? mNumPoints / pointsPerSlice : 1;
+	mNumSlices = mNumSlices < 1 ? 1 : (mNumSlices > mRowLength ? mRowLength : mNumSlices);
+
+	mTwiddles.resize(mNumPoints);
+	for (int j = 0; j < mNumPoints; j++)
+	{
+		auto phase = -2.0 * M_PI * j / mNumPoints;
+		mTwiddles[j] = std::complex<float>((float)cos(phase), (float)sin(phase));
+	}
+
+	mSplitTwiddles.resize(mNumPoints / 2 + 1);
+	for (int k = 0; k <= mNumPoints / 2; k++)
+	{
+		auto phase = -2.0 * M_PI * k / mSize;
+		mSplitTwiddles[k] = std::complex<float>((float)cos(phase), (float)sin(phase));
+	}
+}
+
+inline std::complex<float>* SlicedFFT::transform(const FFTBackend& plan, std::complex<float>* scratch) const
+{
+	auto* transformed = scratch + mScratchStride;
+	auto* work = reinterpret_cast<float*>(scratch + 2 * mScratchStride);
+	plan.performComplexForward(reinterpret_cast<const float*>(scratch), reinterpret_cast<float*>(transformed), work);
+	return transformed;
+}
+
+inline void SlicedFFT::performRows(int slice, const CircularBuffer<float>::Spans& spans, const float* window, int windowSize,
+	std::complex<float>* bins, std::complex<float>* scratch) const
+{
+	auto rowsPerSlice = mColumnLength / mNumSlices;
+	auto mask = mNumPoints - 1;
+
+	for (int q = slice * rowsPerSlice; q < (slice + 1) * rowsPerSlice; q++)
+	{
+		// --- point m = Q p + q holds the windowed samples 2m and 2m + 1
+		for (int p = 0; p < mRowLength; p++)
+		{
+			auto n = 2 * (mColumnLength * p + q);
+			auto re = 0.0f;
+			auto im = 0.0f;
+			if (n < windowSize)
+			{
+				re = (n < spans.size1 ? spans.data1[n] : spans.data2[n - spans.size1]) * window[n];
+				im = (n + 1 < spans.size1 ? spans.data1[n + 1] : spans.data2[n + 1 - spans.size1]) * window[n + 1];
+			}
+			scratch[p] = std::complex<float>(re, im);
+		}
+
+		auto* transformed = transform(*mRowPlan, scratch);
+
+		auto* row = bins + (size_t)mRowLength * q;
+		for (int k = 0; k < mRowLength; k++)
+		{
+			row[k] = multiply(transformed[k], mTwiddles[(q * k) & mask]);
+		}
+	}
+}
+
+inline void SlicedFFT::performColumns(int slice, std::complex<float>* bins, std::complex<float>* scratch) const
+{
+	auto columnsPerSlice = mRowLength / mNumSlices;
+
+	for (int k = slice * columnsPerSlice; k < (slice + 1) * columnsPerSlice; k++)
+	{
+		for (int q = 0; q < mColumnLength; q++)
+		{
+			scratch[q] = bins[(size_t)mRowLength * q + k];
+		}
+
+		auto* transformed = transform(*mColumnPlan, scratch);
+
+		// --- back into the same column, which puts bin k + P j at P j + k
+		for (int j = 0; j < mColumnLength; j++)
+		{
+			bins[(size_t)mRowLength * j + k] = transformed[j];
+		}
+	}
+}
+
+inline void SlicedFFT::performSplit(int slice, std::complex<float>* bins) const
+{
+	// --- bins k and M - k only depend on each other, a slice owns both ends
+	auto half = mNumPoints / 2;
+	auto pairsPerSlice = half / mNumSlices;
+	auto begin = slice * pairsPerSlice + 1;
+	auto end = slice == mNumSlices - 1 ? half : (slice + 1) * pairsPerSlice;
+
+	if (slice == 0)
+	{
+		auto z = bins[0];
+		bins[0] = std::complex<float>(z.real() + z.imag(), 0.0f);
+		bins[mNumPoints] = std::complex<float>(z.real() - z.imag(), 0.0f);
+	}
+
+	for (int k = begin; k <= end; k++)
+	{
+		auto a = bins[k];
+		auto b = std::conj(bins[mNumPoints - k]);
+		// --- even = (a + b) / 2, odd = (a - b) / 2i
+		auto even = 0.5f * (a + b);
+		auto difference = 0.5f * (a - b);
+		auto odd = std::complex<float>(difference.imag(), -difference.real());
+		auto rotated = multiply(odd, mSplitTwiddles[k]);
+
+		bins[k] = even + rotated;
+		if (k != mNumPoints - k)
+		{
+			bins[mNumPoints - k] = std::conj(even - rotated);
+		}
+	}
+}
+
+inline void SlicedFFT::performRealForward(const CircularBuffer<float>::Spans& spans, const float* window, int windowSize,
+	std::complex<float>* bins, std::complex<float>* scratch) const
+{
+	for (int slice = 0; slice < mNumSlices; slice++)
+		performRows(slice, spans, window, windowSize, bins, scratch);
+	for (int slice = 0; slice < mNumSlices; slice++)
+		performColumns(slice, bins, scratch);
+	for (int slice = 0; slice < mNumSlices; slice++)
+		performSplit(slice, bins);
+}
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    SlidingDFT.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include "SpectrumKernels.h"
+
+//==============================================================================
+/**
+	A band of DFT bins over the last N samples, brought up to date with every
+	input sample at a cost of O(1) per bin.
+
+	Modulated form (Duda): instead of a resonator per bin, which rings on with
+	its rounding error for ever, each bin sums (x[n] - x[n - N]) * W^(k m) with
+	m = n mod N, and the phase is taken out when the bins are read. The phasors
+	W^(k m) advance by one complex multiply per sample and are set back to 1
+	every N samples. Alongside, a fresh sum of x[n] * W^(k m) starts from zero
+	at every wrap; at the next wrap it covers exactly the last N samples and
+	replaces the running sum, so the rounding of the additions and subtractions
+	never builds up beyond one window either. The bins are kept as separate
+	real and imaginary arrays and updated a vector at a time.
+
+	After a reset the window fills up from silence, the delayed samples are not
+	subtracted until N new ones have gone in.
+
+	The band is read with a periodic Hann window, applied as the three taps
+	0.5 X[k] - 0.25 (X[k - 1] + X[k + 1]), so one bin past each end is tracked.
+	Power is scaled like the processor's FFT frames with the Hann coherent gain.
+*/
+class SlidingDFT
+{
+public:
+	static constexpr float coherentGain = 0.5f;
+
+	SlidingDFT()
+	{
+		mSize = 0;
+		mMask = 0;
+		mFirstBin = 0;
+		mNumBins = 0;
+		mStride = 0;
+		mNumChannels = 0;
+		mIndex = 0;
+		mNumFilled = 0;
+	};
+
+	~SlidingDFT()
+	{
+	};
+
+	// --- window of 2^order samples, bins firstBin .. firstBin + numBins - 1 clipped to 0 .. N / 2
+	void createSlidingDFT(int numChannels, int order, int firstBin, int numBins);
+	void reset();
+
+	// --- input[c] holds the newest samples of channel c, delayed[c] the ones N samples before them
+	void process(const float* const* input, const float* const* delayed, int numChannels, int numSamples);
+	// --- windowed power of the band, 4 |X|^2 averaged over the first numChannels
+	void getPower(float* power, int numChannels) const;
+
+	int getSize() const { return mSize; }
+	int getFirstBin() const { return mFirstBin; }
+	int getNumBins() const { return mNumBins; }
+	int getNumChannels() const { return mNumChannels; }
+
+private:
+	std::complex<float> getBin(int channel, int tracked) const;
+
+	// --- tracked bin j is bin mFirstBin - 1 + j, every array is padded to a multiple of 8
+	std::vector<float> mPhasorRe;
+	std::vector<float> mPhasorIm;
+	std::vector<float> mStepRe;
+	std::vector<float> mStepIm;
+	// --- mStride values per channel
+	std::vector<float> mSumRe;
+	std::vector<float> mSumIm;
+	std::vector<float> mFreshRe;
+	std::vector<float> mFreshIm;
+	// --- W^j for j < N, to take the phase out when reading
+	std::vector<std::complex<float>> mTwiddles;
+	int mSize;
+	int mMask;
+	int mFirstBin;
+	int mNumBins;
+	int mStride;
+	int mNumChannels;
+	// --- position of the next sample inside the window, m above
+	int mIndex;
+	// --- samples since the reset, up to N
+	int mNumFilled;
+};
+
+inline void SlidingDFT::createSlidingDFT(int numChannels, int order, int firstBin, int numBins)
+{
+	mSize = 1 << order;
+	mMask = mSize - 1;
+	mFirstBin = firstBin < 0 ? 0 : (firstBin > mSize / 2 ? mSize / 2 : firstBin);
+	mNumBins = numBins > mSize / 2 + 1 - mFirstBin ? mSize / 2 + 1 - mFirstBin : (numBins < 1 ? 1 : numBins);
+	mStride = (mNumBins + 2 + 7) & ~7;
+	mNumChannels = numChannels < 1 ? 1 : numChannels;
+
+	mTwiddles.resize(mSize);
+	for (int j = 0; j < mSize; j++)
+	{
+		auto phase = -2.0 * M_PI * j / mSize;
+		mTwiddles[j] = std::complex<float>((float)cos(phase), (float)sin(phase));
+	}
+
+	// --- padding steps by 1, its sums are never read
+	mStepRe.assign(mStride, 1.0f);
+	mStepIm.assign(mStride, 0.0f);
+	for (int j = 0; j < mNumBins + 2; j++)
+	{
+		auto twiddle = mTwiddles[(mFirstBin - 1 + j) & mMask];
+		mStepRe[j] = twiddle.real();
+		mStepIm[j] = twiddle.imag();
+	}
+
+	mPhasorRe.resize(mStride);
+	mPhasorIm.resize(mStride);
+	mSumRe.resize((size_t)mStride * mNumChannels);
+	mSumIm.resize((size_t)mStride * mNumChannels);
+	mFreshRe.resize((size_t)mStride * mNumChannels);
+	mFreshIm.resize((size_t)mStride * mNumChannels);
+	reset();
+}
+
+inline void SlidingDFT::reset()
+{
+	std::fill(mPhasorRe.begin(), mPhasorRe.end(), 1.0f);
+	std::fill(mPhasorIm.begin(), mPhasorIm.end(), 0.0f);
+	std::fill(mSumRe.begin(), mSumRe.end(), 0.0f);
+	std::fill(mSumIm.begin(), mSumIm.end(), 0.0f);
+	std::fill(mFreshRe.begin(), mFreshRe.end(), 0.0f);
+	std::fill(mFreshIm.begin(), mFreshIm.end(), 0.0f);
+	mIndex = 0;
+	mNumFilled = 0;
+}
+
+inline void SlidingDFT::process(const float* const* input, const float* const* delayed, int numChannels, int numSamples)
+{
+	numChannels = numChannels > mNumChannels ? mNumChannels : numChannels;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		auto isFilled = mNumFilled == mSize;
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			auto offset = (size_t)mStride * channel;
+			auto sample = input[channel][i];
+			auto difference = isFilled ? sample - delayed[channel][i] : sample;
+			SpectrumKernels::slidingAccumulate(mSumRe.data() + offset, mSumIm.data() + offset,
+				mFreshRe.data() + offset, mFreshIm.data() + offset,
+				mPhasorRe.data(), mPhasorIm.data(), difference, sample, mStride);
+		}
+		mNumFilled += isFilled ? 0 : 1;
+
+		if (++mIndex == mSize)
+		{
+			// --- the fresh sums now hold exactly the last N samples
+			mSumRe.swap(mFreshRe);
+			mSumIm.swap(mFreshIm);
+			std::fill(mFreshRe.begin(), mFreshRe.end(), 0.0f);
+			std::fill(mFreshIm.begin(), mFreshIm.end(), 0.0f);
+			std::fill(mPhasorRe.begin(), mPhasorRe.end(), 1.0f);
+			std::fill(mPhasorIm.begin(), mPhasorIm.end(), 0.0f);
+			mIndex = 0;
+		}
+		else
+		{
+			SpectrumKernels::complexRotate(mPhasorRe.data(), mPhasorIm.data(), mStepRe.data(), mStepIm.data(), mStride);
+		}
+	}
+}
+
+inline std::complex<float> SlidingDFT::getBin(int channel, int tracked) const
+{
+	// --- the sums are relative to the start of the modulation, the window starts mIndex samples later
+	auto offset = (size_t)mStride * channel + tracked;
+	auto k = mFirstBin - 1 + tracked;
+	return std::complex<float>(mSumRe[offset], mSumIm[offset]) * std::conj(mTwiddles[(k * mIndex) & mMask]);
+}
+
+inline void SlidingDFT::getPower(float* power, int numChannels) const
+{
+	numChannels = numChannels > mNumChannels ? mNumChannels : (numChannels < 1 ? 1 : numChannels);
+	auto scale = 4.0f / (float)numChannels;
+
+	for (int bin = 0; bin < mNumBins; bin++)
+	{
+		auto sum = 0.0f;
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			auto windowed = 0.5f * getBin(channel, bin + 1) - 0.25f * (getBin(channel, bin) + getBin(channel, bin + 2));
+			sum += std::norm(windowed);
+		}
+		power[bin] = scale * sum;
+	}
+}
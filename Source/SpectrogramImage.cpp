@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    SpectrogramImage.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "SpectrogramImage.h"
+
+SpectrogramImage::SpectrogramImage()
+{
+	writeX = 0;
+
+	// colour map lookup table, built once so a column only costs one table read per pixel
+	juce::ColourGradient gradient;
+	gradient.addColour(0.00, juce::Colour(0xff000000));
+	gradient.addColour(0.25, juce::Colour(0xff2c0b5e));
+	gradient.addColour(0.50, juce::Colour(0xff9a2865));
+	gradient.addColour(0.75, juce::Colour(0xfff06b2a));
+	gradient.addColour(1.00, juce::Colour(0xfffcf6b5));
+
+	for (int i = 0; i < colourMapSize; i++)
+	{
+		colourMap[i] = gradient.getColourAtPosition((double)i / (colourMapSize - 1)).getPixelARGB();
+	}
+}
+
+void SpectrogramImage::createImage(int width, int height)
+{
+	if (width <= 0 || height <= 0)
+	{
+		image = juce::Image();
+		writeX = 0;
+		return;
+	}
+
+	// software image, so BitmapData writes go straight into the pixels
+	image = juce::Image(juce::Image::ARGB, width, height, false, juce::SoftwareImageType());
+	image.clear(image.getBounds(), juce::Colour(colourMap[0]));
+	writeX = 0;
+}
+
+void SpectrogramImage::pushColumn(const float* levels)
+{
+	if (!image.isValid())
+	{
+		return;
+	}
+
+	auto height = image.getHeight();
+	juce::Image::BitmapData bitmap(image, writeX, 0, 1, height, juce::Image::BitmapData::writeOnly);
+
+	for (int y = 0; y < height; y++)
+	{
+		auto index = juce::jlimit(0, colourMapSize - 1, (int)(levels[height - 1 - y] * (colourMapSize - 1)));
+		reinterpret_cast<juce::PixelARGB*>(bitmap.getLinePointer(y))->set(colourMap[index]);
+	}
+
+	writeX = (writeX + 1) % image.getWidth();
+}
+
+void SpectrogramImage::draw(juce::Graphics& g, int x, int y) const
+{
+	if (!image.isValid())
+	{
+		return;
+	}
+
+	auto width = image.getWidth();
+	auto height = image.getHeight();
+	auto olderWidth = width - writeX;
+
+	g.setOpacity(1.0f);
+	// oldest columns sit right of the cursor, the newest ones wrapped around to the left
+	g.drawImage(image, x, y, olderWidth, height, writeX, 0, olderWidth, height);
+	if (writeX > 0)
+	{
+		g.drawImage(image, x + olderWidth, y, writeX, height, 0, 0, writeX, height);
+	}
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    SpectrogramImage.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Scrolling time-frequency view kept in a preallocated software image that is
+	used as a ring buffer: every frame overwrites one column at the write cursor,
+	and drawing is two blits (oldest part, then the wrapped newest part), so
+	nothing is scrolled or reallocated per frame.
+*/
+class SpectrogramImage
+{
+public:
+	SpectrogramImage();
+
+	// clears the history, call from resized()
+	void createImage(int width, int height);
+
+	// levels are normalised 0..1, one per row, index 0 is the bottom (lowest) row
+	void pushColumn(const float* levels);
+
+	void draw(juce::Graphics& g, int x, int y) const;
+
+	int getWidth() const { return image.getWidth(); }
+	int getHeight() const { return image.getHeight(); }
+
+private:
+	static constexpr int colourMapSize = 256;
+
+	juce::Image image;
+	int writeX;
+	juce::PixelARGB colourMap[colourMapSize];
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramImage)
+};
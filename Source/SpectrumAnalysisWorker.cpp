@@ -0,0 +1,374 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysisWorker.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalysisWorker.h"
+
+SpectrumAnalysisWorker::SpectrumAnalysisWorker(SpectrumFifo& source)
+	: juce::Thread("Spectrum Analysis"), fifo(source)
+{
+	peakTracker.createPeakTracker(numTrackedPeaks);
+	working.peaks.reserve(numTrackedPeaks);
+}
+
+SpectrumAnalysisWorker::~SpectrumAnalysisWorker()
+{
+	stopThread(1000);
+}
+
+void SpectrumAnalysisWorker::setSettings(const DisplaySettings& newSettings)
+{
+	const juce::ScopedLock sl(lock);
+
+	if (newSettings == pendingSettings)
+	{
+		return;
+	}
+
+	// spectrogram height changed, queued columns no longer fit
+	if (newSettings.numRows != columnRows)
+	{
+		columnRows = newSettings.numRows;
+		columnRing.assign((size_t)numColumnSlots * (size_t)columnRows, 0.0f);
+		columnRead = 0;
+		columnWrite = 0;
+	}
+
+	pendingSettings = newSettings;
+}
+
+bool SpectrumAnalysisWorker::getLatestFrame(DisplayFrame& destination)
+{
+	const juce::ScopedLock sl(lock);
+
+	if (!hasNewFrame)
+	{
+		return false;
+	}
+
+	// vectors keep their capacity, so this only allocates when the layout grows
+	destination = published;
+	hasNewFrame = false;
+	return true;
+}
+
+bool SpectrumAnalysisWorker::popColumn(float* destination, int numRows)
+{
+	const juce::ScopedLock sl(lock);
+
+	if (numRows != columnRows || columnRead == columnWrite)
+	{
+		return false;
+	}
+
+	memcpy(destination, columnRing.data() + (size_t)(columnRead % numColumnSlots) * columnRows, sizeof(float) * columnRows);
+	columnRead++;
+	return true;
+}
+
+void SpectrumAnalysisWorker::run()
+{
+	while (!threadShouldExit())
+	{
+		{
+			const juce::ScopedLock sl(lock);
+			settings = pendingSettings;
+		}
+
+		// --- frames that changed what is shown, skipped ones still leave the fifo
+		auto numFrames = 0;
+		if (settings.takeNewestFrameOnly)
+		{
+			if (auto* frame = fifo.beginReadLatest())
+			{
+				numFrames += processFrame(*frame) ? 1 : 0;
+				fifo.finishRead();
+			}
+		}
+		else
+		{
+			while (auto* frame = fifo.beginRead())
+			{
+				numFrames += processFrame(*frame) ? 1 : 0;
+				fifo.finishRead();
+			}
+		}
+
+		if (numFrames > 0)
+		{
+			publishFrame();
+		}
+		else
+		{
+			wait(2);
+		}
+	}
+}
+
+void SpectrumAnalysisWorker::powerToLevel(float* values, int numValues, float V0) const
+{
+	// power to dB relative to full scale in one vector pass, then clip and normalise
+	SpectrumKernels::powerToDecibels(values, values, numValues, V0, minPower);
+
+	for (int i = 0; i < numValues; i++)
+	{
+		auto level_limited = juce::jlimit(settings.mindB, settings.maxdB, values[i]);
+		values[i] = juce::jmap(level_limited, settings.mindB, settings.maxdB, 0.0f, 1.0f);
+	}
+}
+
+bool SpectrumAnalysisWorker::processFrame(const SpectrumFrame& frame)
+{
+	// given up by the processor after it missed its deadline
+	if (frame.numSources <= 0)
+	{
+		return false;
+	}
+
+	// shorter layers only refresh their own power, the composite below picks up the newest of each
+	auto layer = juce::jlimit(0, SpectrumComposite::maxNumLayers - 1, frame.layer);
+	if (layer == 0 && onLongestFrame != nullptr)
+	{
+		onLongestFrame(frame);
+	}
+
+	numLayers = juce::jlimit(1, SpectrumComposite::maxNumLayers, frame.numLayers);
+	if (layer > 0)
+	{
+		// constant-Q bands already trade time for frequency per band, they only use the longest window
+		if (settings.bandsPerOctave > 0 || bandsPerOctave > 0 || numBins == 0)
+		{
+			return false;
+		}
+
+		layerPower[layer].resize(frame.numBins);
+		sumSourcePower(frame, layerPower[layer].data());
+		layerWindowSize[layer] = frame.windowSize > 0 ? frame.windowSize : frame.fftSize;
+		layerFFTSize[layer] = frame.fftSize;
+		layerGain[layer] = (float)layerWindowSize[layer] * frame.coherentGain;
+	}
+	else
+	{
+		processMainLayer(frame);
+	}
+
+	auto V0 = juce::Decibels::gainToDecibels((float)windowSize * coherentGain);
+
+	// constant-Q bands from the complex bins, one sparse row product per band and channel
+	auto* values = currentOutputArray.data();
+	if (bandsPerOctave > 0)
+	{
+		auto numSources = juce::jmax(1, frame.numSources);
+		auto scale = 4.0f / (float)numSources;
+		constantQ.createConstantQKernel(bandsPerOctave, settings.sampleRate, fftSize, windowSize, frame.windowTag);
+		bandPower.resize(numValues);
+		constantQ.apply(frame.bins.get(), bandPower.data(), scale);
+		if (numSources > 1)
+		{
+			sourcePower.resize(numValues);
+			for (int source = 1; source < numSources; source++)
+			{
+				constantQ.apply(frame.bins.get() + source * numBins, sourcePower.data(), scale);
+				juce::FloatVectorOperations::add(bandPower.data(), sourcePower.data(), numValues);
+			}
+		}
+		values = bandPower.data();
+	}
+	else if (numLayers > 1)
+	{
+		// every layer has to have delivered once, until then the longest window is shown on its own
+		const float* powers[SpectrumComposite::maxNumLayers] = { currentOutputArray.data() };
+		float gains[SpectrumComposite::maxNumLayers] = { 1.0f };
+		auto isReady = true;
+		for (int i = 1; i < numLayers; i++)
+		{
+			isReady = isReady && layerPower[i].size() == (size_t)(layerFFTSize[i] / 2 + 1) && layerGain[i] > 0.0f;
+			powers[i] = layerPower[i].data();
+			gains[i] = isReady ? (layerGain[0] / layerGain[i]) * (layerGain[0] / layerGain[i]) : 0.0f;
+		}
+
+		if (isReady)
+		{
+			composite.createSpectrumComposite(numLayers, layerWindowSize, layerFFTSize, settings.sampleRate);
+			compositePower.resize(composite.getNumBins());
+			composite.combine(powers, gains, compositePower.data());
+			values = compositePower.data();
+		}
+	}
+
+	auto ratio = getSmoothingCoefficient(frame, layer);
+	SpectrumKernels::smooth(previousOutputArray.data(), values, numValues, ratio, ratio);
+
+	// one spectrogram column per frame of the longest window, unsmoothed, row 0 is the lowest frequency
+	auto numRows = settings.numRows;
+	if (numRows > 0 && layer == 0)
+	{
+		column.resize(numRows);
+		rowAxis.createFrequencyAxis(numRows, numValues, getAxisSkew(), settings.sampleRate);
+		rowAxis.aggregate(values, column.data(), settings.aggregationMode);
+
+		powerToLevel(column.data(), numRows, V0);
+
+		// editor is behind when the ring is full, the column is dropped
+		const juce::ScopedLock sl(lock);
+		if (numRows == columnRows && columnWrite - columnRead < numColumnSlots)
+		{
+			memcpy(columnRing.data() + (size_t)(columnWrite % numColumnSlots) * columnRows, column.data(), sizeof(float) * columnRows);
+			columnWrite++;
+		}
+	}
+	return true;
+}
+
+void SpectrumAnalysisWorker::processMainLayer(const SpectrumFrame& frame)
+{
+	// transform size or band layout changed, the smoothing starts again
+	auto frameValues = settings.bandsPerOctave > 0 ? ConstantQKernel::getNumBands(settings.bandsPerOctave, settings.sampleRate) : frame.numBins;
+	if (frame.numBins != numBins || frameValues != numValues || settings.bandsPerOctave != bandsPerOctave)
+	{
+		currentOutputArray.assign(frame.numBins, 0.0f);
+		previousOutputArray.assign(frameValues, 0.0f);
+	}
+	fftSize = frame.fftSize;
+	windowSize = frame.windowSize > 0 ? frame.windowSize : frame.fftSize;
+	numBins = frame.numBins;
+	numValues = frameValues;
+	bandsPerOctave = settings.bandsPerOctave;
+	coherentGain = frame.coherentGain;
+
+	sumSourcePower(frame, currentOutputArray.data());
+	layerWindowSize[0] = windowSize;
+	layerFFTSize[0] = fftSize;
+	layerGain[0] = (float)windowSize * coherentGain;
+
+	auto V0 = juce::Decibels::gainToDecibels((float)windowSize * coherentGain);
+	trackPeaks(frame, V0);
+}
+
+float SpectrumAnalysisWorker::getSmoothingCoefficient(const SpectrumFrame& frame, int layer)
+{
+	// the forgetting factor is per hop of the longest window, shorter layers arrive more often and
+	// frames skipped to stay on the newest leave longer gaps, both count by the input they cover
+	if (layer == 0 && frame.hopSize > 0)
+	{
+		longestHop = frame.hopSize;
+	}
+	auto coefficient = settings.ratio / 100.0f;
+	auto elapsed = frame.samplePosition - smoothedPosition;
+	auto isSteady = smoothedPosition >= 0 && elapsed > 0 && longestHop > 0;
+	smoothedPosition = frame.samplePosition;
+	if (!isSteady)
+	{
+		return coefficient;
+	}
+	return 1.0f - std::pow(1.0f - coefficient, (float)elapsed / (float)longestHop);
+}
+
+void SpectrumAnalysisWorker::sumSourcePower(const SpectrumFrame& frame, float* power)
+{
+	// power of the doubled magnitude, to compensate the data outside nyquist,
+	// averaged over the channels when the frame carries more than one
+	auto numSources = juce::jmax(1, frame.numSources);
+	auto scale = 4.0f / (float)numSources;
+	SpectrumKernels::squaredMagnitude(frame.bins.get(), power, frame.numBins, scale);
+	if (numSources > 1)
+	{
+		sourcePower.resize(frame.numBins);
+		for (int source = 1; source < numSources; source++)
+		{
+			SpectrumKernels::squaredMagnitude(frame.bins.get() + source * frame.numBins, sourcePower.data(), frame.numBins, scale);
+			juce::FloatVectorOperations::add(power, sourcePower.data(), frame.numBins);
+		}
+	}
+}
+
+void SpectrumAnalysisWorker::trackPeaks(const SpectrumFrame& frame, float V0)
+{
+	// every frame, unsmoothed, so a short tone is not averaged away before it is seen
+	peakTracker.setWindow(frame.windowTag);
+	// nothing below the bottom of the display is worth reporting
+	auto threshold = std::pow(10.0f, (settings.mindB + V0) / 10.0f);
+	auto numFound = peakTracker.findPeaks(currentOutputArray.data(), numBins, (float)windowSize / (float)fftSize, threshold);
+
+	auto binWidth = (float)(settings.sampleRate / fftSize);
+	working.peaks.resize(numFound);
+	for (int i = 0; i < numFound; i++)
+	{
+		auto& peak = peakTracker.getPeak(i);
+		working.peaks[i].frequency = peak.bin * binWidth;
+		working.peaks[i].level = 10.0f * std::log10(juce::jmax(peak.power, minPower)) - V0;
+	}
+
+	// restarted transport, positions before it mean nothing
+	samplePosition = frame.samplePosition;
+	if (samplePosition < peakHoldPosition)
+	{
+		peakHoldPosition = samplePosition;
+	}
+
+	if (numFound > 0 && working.peaks[0].level >= getHeldLevel())
+	{
+		peakHold = working.peaks[0];
+		peakHoldPosition = samplePosition;
+	}
+}
+
+float SpectrumAnalysisWorker::getHeldLevel() const
+{
+	auto seconds = (double)(samplePosition - peakHoldPosition) / settings.sampleRate;
+	auto decay = peakDecayPerSecond * juce::jmax(0.0, seconds - peakHoldSeconds);
+	return juce::jmax(settings.mindB, peakHold.level - (float)decay);
+}
+
+void SpectrumAnalysisWorker::publishFrame()
+{
+	// nothing of the longest window has arrived yet, there is no spectrum to map
+	if (numValues <= 0)
+	{
+		return;
+	}
+
+	// full scale reference only depends on the window, zero padding adds bins but no energy
+	auto V0 = juce::Decibels::gainToDecibels((float)windowSize * coherentGain);
+	auto* power = previousOutputArray.data();
+	auto numLinePoints = juce::jmax(0, settings.numLinePoints);
+	auto numBars = juce::jmax(0, settings.numBars);
+
+	// line graph, either lineScopeSize points or a min/max pair per pixel column
+	lineAxis.createFrequencyAxis(numLinePoints, numValues, getAxisSkew(), settings.sampleRate);
+	working.line.resize(numLinePoints);
+	if (settings.decimateToPixels)
+	{
+		working.lineMin.resize(numLinePoints);
+		lineAxis.aggregateMinMax(power, working.lineMin.data(), working.line.data());
+	}
+	else
+	{
+		working.lineMin.clear();
+		lineAxis.aggregate(power, working.line.data(), settings.aggregationMode);
+	}
+
+	powerToLevel(working.line.data(), numLinePoints, V0);
+	powerToLevel(working.lineMin.data(), (int)working.lineMin.size(), V0);
+
+	// bar graph
+	barAxis.createFrequencyAxis(numBars, numValues, getAxisSkew(), settings.sampleRate);
+	working.bars.resize(numBars);
+	barAxis.aggregate(power, working.bars.data(), settings.aggregationMode);
+	powerToLevel(working.bars.data(), numBars, V0);
+
+	working.peakHold.frequency = peakHold.frequency;
+	working.peakHold.level = getHeldLevel();
+	working.fftSize = fftSize;
+	working.numBins = numBins;
+
+	const juce::ScopedLock sl(lock);
+	published = working;
+	hasNewFrame = true;
+}
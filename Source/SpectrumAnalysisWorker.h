@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysisWorker.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "SpectrumFifo.h"
+#include "FrequencyAxis.h"
+#include "SpectrumKernels.h"
+#include "PeakTracker.h"
+#include "ConstantQKernel.h"
+#include "SpectrumComposite.h"
+
+//==============================================================================
+/**
+	What the editor currently shows, pushed to the worker whenever it changes.
+*/
+struct DisplaySettings
+{
+	int numLinePoints = 0;
+	bool decimateToPixels = false;
+	int numBars = 0;
+	int numRows = 0;
+	float skew = 1.0f;
+	// --- 0 shows the FFT bins, otherwise constant-Q bands with this many per octave on a log axis
+	int bandsPerOctave = 0;
+	int aggregationMode = kAggregateMax;
+	float ratio = 20.0f;
+	float mindB = -100.0f;
+	float maxdB = 0.0f;
+	double sampleRate = 44100.0;
+	// false: every queued frame goes through the smoothing, true: only the newest one is used
+	bool takeNewestFrameOnly = false;
+
+	bool operator== (const DisplaySettings& other) const
+	{
+		return numLinePoints == other.numLinePoints && decimateToPixels == other.decimateToPixels
+			&& numBars == other.numBars && numRows == other.numRows && skew == other.skew
+			&& bandsPerOctave == other.bandsPerOctave
+			&& aggregationMode == other.aggregationMode && ratio == other.ratio
+			&& mindB == other.mindB && maxdB == other.maxdB && sampleRate == other.sampleRate
+			&& takeNewestFrameOnly == other.takeNewestFrameOnly;
+	}
+	bool operator!= (const DisplaySettings& other) const { return !(*this == other); }
+};
+
+struct DisplayPeak
+{
+	float frequency = 0.0f;
+	float level = -100.0f;
+};
+
+//==============================================================================
+/**
+	Display-ready data, levels normalised 0..1 between mindB and maxdB. Peaks
+	are in Hz and dB relative to a full scale sine.
+*/
+struct DisplayFrame
+{
+	// --- line points, or the per pixel maximum when decimating
+	std::vector<float> line;
+	// --- per pixel minimum, only filled when decimating
+	std::vector<float> lineMin;
+	std::vector<float> bars;
+	// --- strongest peaks of the newest frame, strongest first
+	std::vector<DisplayPeak> peaks;
+	// --- strongest peak seen lately, held for a second and then falling
+	DisplayPeak peakHold;
+	int fftSize = 0;
+	int numBins = 0;
+};
+
+//==============================================================================
+/**
+	Consumes raw frames from the processor's SpectrumFifo on its own thread and
+	does everything that scales with the FFT size: magnitudes, the optional
+	constant-Q bands or multi-resolution composite, smoothing, dB conversion, peak
+	tracking and the bin-to-column aggregation. The editor only copies the result,
+	so its time per frame is bounded by the display size.
+
+	The processor owns it and runs it from prepareToPlay on, so it can be stopped
+	before the fifo is rebuilt. An editor attaches by pushing its settings, and
+	onLongestFrame sees every frame of the longest window whether one is attached
+	or not.
+*/
+class SpectrumAnalysisWorker : public juce::Thread
+{
+public:
+	explicit SpectrumAnalysisWorker(SpectrumFifo& source);
+	~SpectrumAnalysisWorker() override;
+
+	void setSettings(const DisplaySettings& newSettings);
+
+	// --- worker thread, each frame of the longest window before anything the display asks for,
+	//     set before the thread starts
+	std::function<void(const SpectrumFrame&)> onLongestFrame;
+
+	// --- message thread, false when nothing new was published since the last call
+	bool getLatestFrame(DisplayFrame& destination);
+	// --- message thread, one spectrogram column per analysed frame, oldest first
+	bool popColumn(float* destination, int numRows);
+
+	void run() override;
+
+private:
+	// --- false when the frame was skipped and nothing that is shown changed
+	bool processFrame(const SpectrumFrame& frame);
+	void processMainLayer(const SpectrumFrame& frame);
+	void sumSourcePower(const SpectrumFrame& frame, float* power);
+	// --- the forgetting factor scaled to the input this frame covers, in hops of the longest window
+	float getSmoothingCoefficient(const SpectrumFrame& frame, int layer);
+	void publishFrame();
+	void powerToLevel(float* values, int numValues, float V0) const;
+	void trackPeaks(const SpectrumFrame& frame, float V0);
+	float getHeldLevel() const;
+	float getAxisSkew() const { return bandsPerOctave > 0 ? 1.0f : settings.skew; }
+
+	// --- -200dB floor for the log, far below anything the display shows
+	static constexpr float minPower = 1.0e-20f;
+	static constexpr int numTrackedPeaks = 8;
+	static constexpr double peakHoldSeconds = 1.0;
+	static constexpr double peakDecayPerSecond = 20.0;
+
+	SpectrumFifo& fifo;
+
+	// --- worker thread only, spectra are kept as power
+	DisplaySettings settings;
+	std::vector<float> currentOutputArray;
+	std::vector<float> previousOutputArray;
+	std::vector<float> column;
+	// --- one channel's power before it is summed into currentOutputArray or bandPower
+	std::vector<float> sourcePower;
+	std::vector<float> bandPower;
+	ConstantQKernel constantQ;
+	// --- newest power of the shorter layers, layer 0 is currentOutputArray, stitched into compositePower
+	std::vector<float> layerPower[SpectrumComposite::maxNumLayers];
+	int layerWindowSize[SpectrumComposite::maxNumLayers] = {};
+	int layerFFTSize[SpectrumComposite::maxNumLayers] = {};
+	float layerGain[SpectrumComposite::maxNumLayers] = {};
+	std::vector<float> compositePower;
+	SpectrumComposite composite;
+	int numLayers = 1;
+	FrequencyAxis lineAxis;
+	FrequencyAxis barAxis;
+	FrequencyAxis rowAxis;
+	DisplayFrame working;
+	int fftSize = 0;
+	int windowSize = 0;
+	int numBins = 0;
+	// --- what gets smoothed and displayed, numBins bins or the constant-Q bands
+	int numValues = 0;
+	int bandsPerOctave = 0;
+	float coherentGain = 1.0f;
+	PeakTracker peakTracker;
+	// --- level and input position when the hold was last raised
+	DisplayPeak peakHold;
+	juce::int64 peakHoldPosition = 0;
+	juce::int64 samplePosition = 0;
+	// --- input position of the last smoothed frame, -1 before the first
+	juce::int64 smoothedPosition = -1;
+	int longestHop = 0;
+
+	// --- shared with the message thread, guarded by lock (neither side is real-time)
+	juce::CriticalSection lock;
+	DisplaySettings pendingSettings;
+	DisplayFrame published;
+	bool hasNewFrame = false;
+	static constexpr int numColumnSlots = 64;
+	std::vector<float> columnRing;
+	int columnRows = 0;
+	int columnRead = 0;
+	int columnWrite = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalysisWorker)
+};
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    SpectrumAverage.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+#include <cstdint>
+#include <vector>
+
+#include "SpectrumKernels.h"
+
+enum SpectrumAverageMode
+{
+	// --- every frame weighs the same, over the overlapped windowed frames this is Welch's estimate
+	kAverageLinear = 1,
+	// --- frames fade with a time constant in seconds
+	kAverageExponential,
+	// --- highest power each value has reached
+	kAveragePeakHold
+};
+
+//==============================================================================
+/**
+	A copy of an average taken for the display: power spectral density per bin
+	of an fftSize point transform, full scale squared per Hz.
+*/
+struct SpectrumAverageSnapshot
+{
+	std::vector<float> density;
+	int fftSize = 0;
+	double sampleRate = 0.0;
+	// --- equivalent noise bandwidth of the newest frame's window in Hz, that window shows
+	//     2 * density * noiseBandwidth for a full scale sine of 0 dB
+	double noiseBandwidth = 0.0;
+	// --- input time the estimate covers
+	double seconds = 0.0;
+};
+
+//==============================================================================
+/**
+	Long-term average of power spectra, for minutes or hours of input.
+
+	The state is one double per value, whatever the duration: the linear mode
+	keeps a running mean, each frame blended in with 1 / count, rather than a
+	sum, so both averaging modes share one kernel and a snapshot is a plain
+	conversion to float. The exponential mode blends with 1 - exp(-dt / tau)
+	per frame, but never less than 1 / count, so it starts out as a linear
+	mean instead of rising from zero.
+
+	The storage is allocated once by createSpectrumAverage. A reset is O(1):
+	it only clears the count, and the next frame is copied over the state
+	instead of blended into it. A change of mode or of the number of values
+	resets too, the old state means nothing for the new ones.
+*/
+class SpectrumAverage
+{
+public:
+	SpectrumAverage()
+	{
+		mMaxValues = 0;
+		mNumValues = 0;
+		mMode = 0;
+		mNumFrames = 0;
+		mSeconds = 0.0;
+	};
+
+	~SpectrumAverage()
+	{
+	};
+
+	// --- the only allocation, frames with more values than maxValues are cut short
+	void createSpectrumAverage(int maxValues);
+	void reset();
+
+	// --- frameSeconds is the input time since the previous frame, timeConstant only matters to kAverageExponential
+	void addFrame(const float* power, int numValues, int mode, double timeConstant, double frameSeconds);
+	// --- getNumValues() values of the estimate so far, false before the first frame
+	bool getSnapshot(float* power) const;
+
+	int getNumValues() const { return mNumValues; }
+	int getMode() const { return mMode; }
+	int64_t getNumFrames() const { return mNumFrames; }
+	// --- input time the estimate covers
+	double getSeconds() const { return mSeconds; }
+
+private:
+	std::vector<double> mState;
+	int mMaxValues;
+	int mNumValues;
+	int mMode;
+	int64_t mNumFrames;
+	double mSeconds;
+};
+
+inline void SpectrumAverage::createSpectrumAverage(int maxValues)
+{
+	mMaxValues = maxValues < 0 ? 0 : maxValues;
+	mState.assign(mMaxValues, 0.0);
+	mNumValues = 0;
+	reset();
+}
+
+inline void SpectrumAverage::reset()
+{
+	mNumFrames = 0;
+	mSeconds = 0.0;
+}
+
+inline void SpectrumAverage::addFrame(const float* power, int numValues, int mode, double timeConstant, double frameSeconds)
+{
+	numValues = numValues < 0 ? 0 : (numValues > mMaxValues ? mMaxValues : numValues);
+	if (mode != mMode || numValues != mNumValues)
+	{
+		mMode = mode;
+		mNumValues = numValues;
+		reset();
+	}
+	if (mNumValues == 0)
+	{
+		return;
+	}
+
+	if (mNumFrames == 0)
+	{
+		SpectrumKernels::widenToDouble(power, mState.data(), mNumValues);
+	}
+	else if (mMode == kAveragePeakHold)
+	{
+		SpectrumKernels::maximumDouble(mState.data(), power, mNumValues);
+	}
+	else
+	{
+		auto coefficient = 1.0 / (double)(mNumFrames + 1);
+		if (mMode == kAverageExponential && timeConstant > 0.0)
+		{
+			auto decay = 1.0 - exp(-frameSeconds / timeConstant);
+			coefficient = decay > coefficient ? decay : coefficient;
+		}
+		SpectrumKernels::blendDouble(mState.data(), power, mNumValues, coefficient);
+	}
+
+	mNumFrames++;
+	mSeconds += frameSeconds;
+}
+
+inline bool SpectrumAverage::getSnapshot(float* power) const
+{
+	if (mNumFrames == 0)
+	{
+		return false;
+	}
+
+	SpectrumKernels::narrowToFloat(mState.data(), power, mNumValues);
+	return true;
+}
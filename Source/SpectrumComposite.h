@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    SpectrumComposite.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <vector>
+
+//==============================================================================
+/**
+	Stitches the power spectra of several window lengths into one spectrum on
+	the bins of the longest (layer 0).
+
+	Layer i takes over from layer i - 1 at crossoverBins of its own window bins,
+	where its resolution is about 1/16 of the frequency, so the bass keeps the
+	long window and the top end gets the short ones' time resolution. Across
+	the octave around each crossover the two layers are blended with a raised
+	cosine in log frequency. Shorter layers are read between their bins by
+	linear interpolation. The tables are only rebuilt when the layer sizes or
+	the sample rate change.
+*/
+class SpectrumComposite
+{
+public:
+	static constexpr int maxNumLayers = 3;
+
+	SpectrumComposite()
+	{
+		mNumLayers = 0;
+		mNumBins = 0;
+		mSampleRate = 0.0;
+	};
+
+	~SpectrumComposite()
+	{
+	};
+
+	// --- window and transform sizes per layer, longest first; returns true when the tables had to be rebuilt
+	bool createSpectrumComposite(int numLayers, const int* windowSizes, const int* fftSizes, double sampleRate);
+
+	int getNumBins() const { return mNumBins; }
+	double getCrossover(int layer) const { return mCrossover[layer]; }
+
+	// --- gains bring each layer to layer 0's full scale reference, output has getNumBins() values
+	void combine(const float* const* layerPower, const float* gains, float* output) const;
+
+private:
+	float sampleLayer(const float* power, int layer, int bin) const;
+
+	static constexpr double crossoverBins = 16.0;
+
+	// --- per output bin, the lower of the two layers in use and the weight of the one above it
+	std::vector<int> mLower;
+	std::vector<float> mBlend;
+	double mCrossover[maxNumLayers] = {};
+	int mWindowSizes[maxNumLayers] = {};
+	int mFFTSizes[maxNumLayers] = {};
+	int mLayerBins[maxNumLayers] = {};
+	// --- bins of layer i per bin of layer 0
+	float mRatio[maxNumLayers] = {};
+	int mNumLayers;
+	int mNumBins;
+	double mSampleRate;
+};
+
+inline bool SpectrumComposite::createSpectrumComposite(int numLayers, const int* windowSizes, const int* fftSizes, double sampleRate)
+{
+	numLayers = numLayers < 1 ? 1 : (numLayers > maxNumLayers ? maxNumLayers : numLayers);
+
+	auto unchanged = numLayers == mNumLayers && sampleRate == mSampleRate;
+	for (int layer = 0; layer < numLayers && unchanged; layer++)
+	{
+		unchanged = windowSizes[layer] == mWindowSizes[layer] && fftSizes[layer] == mFFTSizes[layer];
+	}
+	if (unchanged)
+	{
+		return false;
+	}
+
+	mNumLayers = numLayers;
+	mSampleRate = sampleRate;
+	for (int layer = 0; layer < numLayers; layer++)
+	{
+		mWindowSizes[layer] = windowSizes[layer];
+		mFFTSizes[layer] = fftSizes[layer];
+		mLayerBins[layer] = fftSizes[layer] / 2 + 1;
+		mRatio[layer] = (float)fftSizes[layer] / (float)fftSizes[0];
+		mCrossover[layer] = layer == 0 ? 0.0 : crossoverBins * sampleRate / windowSizes[layer];
+	}
+
+	mNumBins = mLayerBins[0];
+	mLower.resize(mNumBins);
+	mBlend.resize(mNumBins);
+	for (int k = 0; k < mNumBins; k++)
+	{
+		auto frequency = k * sampleRate / fftSizes[0];
+
+		// --- past the blend of a crossover the layer above takes over completely
+		auto lower = 0;
+		for (int layer = 1; layer < numLayers; layer++)
+		{
+			if (frequency >= mCrossover[layer] * sqrt(2.0))
+				lower = layer;
+		}
+
+		auto blend = 0.0;
+		if (lower + 1 < numLayers && frequency > 0.0)
+		{
+			auto octaves = log2(frequency / mCrossover[lower + 1]);
+			if (octaves > -0.5)
+				blend = 0.5 - 0.5 * cos(M_PI * (octaves + 0.5));
+		}
+
+		mLower[k] = lower;
+		mBlend[k] = (float)blend;
+	}
+
+	return true;
+}
+
+inline float SpectrumComposite::sampleLayer(const float* power, int layer, int bin) const
+{
+	if (layer == 0)
+	{
+		return power[bin];
+	}
+
+	auto position = bin * mRatio[layer];
+	auto index = (int)position;
+	if (index >= mLayerBins[layer] - 1)
+	{
+		return power[mLayerBins[layer] - 1];
+	}
+
+	auto frac = position - (float)index;
+	return power[index] + frac * (power[index + 1] - power[index]);
+}
+
+inline void SpectrumComposite::combine(const float* const* layerPower, const float* gains, float* output) const
+{
+	for (int k = 0; k < mNumBins; k++)
+	{
+		auto lower = mLower[k];
+		auto value = gains[lower] * sampleLayer(layerPower[lower], lower, k);
+
+		auto blend = mBlend[k];
+		if (blend > 0.0f)
+		{
+			auto upper = gains[lower + 1] * sampleLayer(layerPower[lower + 1], lower + 1, k);
+			value += blend * (upper - value);
+		}
+		output[k] = value;
+	}
+}
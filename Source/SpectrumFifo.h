@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    SpectrumFifo.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <memory>
+
+//==============================================================================
+/**
+	One analysed frame as handed from the audio thread to the editor.
+*/
+struct SpectrumFrame
+{
+	// --- numSources half spectra back to back, source s starts at bins[s * numBins]
+	std::unique_ptr<std::complex<float>[]> bins = nullptr;
+	int numBins = 0;
+	// --- 0 when the frame was given up after its slot had been taken, consumers skip it
+	int numSources = 1;
+	int fftSize = 0;
+	// --- samples that went into the transform, the rest up to fftSize is zero padding
+	int windowSize = 0;
+	int windowTag = 1;
+	// --- input samples between this layer's frames
+	int hopSize = 0;
+	// --- which of numLayers analyses of the same input this is, 0 is the longest window
+	int layer = 0;
+	int numLayers = 1;
+	float coherentGain = 1.0f;
+	float enbw = 1.0f;
+	// --- increments for every frame the producer wanted to publish, gaps mean overruns
+	uint64_t sequence = 0;
+	// --- input sample count at the end of the frame
+	int64_t samplePosition = 0;
+};
+
+//==============================================================================
+/**
+	Wait-free single-producer / single-consumer ring of preallocated frames.
+
+	The producer (audio thread) calls beginWrite / finishWrite, the consumer
+	(editor) calls beginRead or beginReadLatest followed by finishRead. Neither
+	side blocks or allocates; when the ring is full the producer drops the frame
+	and counts an overrun. A frame the producer gives up before it asks for a
+	slot goes through skipWrite, so it leaves the same sequence gap and counts
+	the same way. The producer may begin several frames before finishing them;
+	finishWrite always publishes the oldest one that was begun, so frames can be
+	filled elsewhere and still arrive in order. createFifo must not run while
+	either side is active.
+*/
+class SpectrumFifo
+{
+public:
+	SpectrumFifo()
+	{
+		mCapacity = 0;
+		mMask = 0;
+		mNextSequence = 0;
+		mReserveIndex = 0;
+	};
+
+	~SpectrumFifo()
+	{
+	};
+
+	void createFifo(unsigned int numFrames, unsigned int maxBins);
+
+	// --- producer side
+	SpectrumFrame* beginWrite();
+	void finishWrite();
+	// --- a frame that will never be written, counted as an overrun
+	void skipWrite();
+
+	// --- consumer side, oldest pending frame or the newest one (skipping the rest)
+	const SpectrumFrame* beginRead();
+	const SpectrumFrame* beginReadLatest();
+	void finishRead();
+
+	int getNumReady() const;
+	uint64_t getOverrunCount() const { return mOverruns.load(std::memory_order_relaxed); }
+	uint64_t getDroppedCount() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+	std::unique_ptr<SpectrumFrame[]> mFrames = nullptr;
+	unsigned int mCapacity;
+	unsigned int mMask;
+	uint64_t mNextSequence;
+	// --- producer only, slots begun but not finished yet sit between mWriteIndex and this
+	uint32_t mReserveIndex;
+
+	// --- free running counters, slot = index & mMask
+	std::atomic<uint32_t> mWriteIndex { 0 };
+	std::atomic<uint32_t> mReadIndex { 0 };
+
+	std::atomic<uint64_t> mOverruns { 0 };
+	std::atomic<uint64_t> mDropped { 0 };
+};
+
+inline void SpectrumFifo::createFifo(unsigned int numFrames, unsigned int maxBins)
+{
+	// --- capacity as power of 2 for the wrap mask
+	mCapacity = 1;
+	while (mCapacity < numFrames)
+		mCapacity <<= 1;
+	mMask = mCapacity - 1;
+
+	mFrames.reset(new SpectrumFrame[mCapacity]);
+	for (unsigned int i = 0; i < mCapacity; i++)
+	{
+		mFrames[i].bins.reset(new std::complex<float>[maxBins]());
+	}
+
+	mNextSequence = 0;
+	mReserveIndex = 0;
+	mWriteIndex.store(0);
+	mReadIndex.store(0);
+	mOverruns.store(0);
+	mDropped.store(0);
+}
+
+inline SpectrumFrame* SpectrumFifo::beginWrite()
+{
+	auto sequence = mNextSequence++;
+	auto readIndex = mReadIndex.load(std::memory_order_acquire);
+
+	if (mFrames == nullptr || mReserveIndex - readIndex >= mCapacity)
+	{
+		mOverruns.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto& frame = mFrames[mReserveIndex++ & mMask];
+	frame.sequence = sequence;
+	return &frame;
+}
+
+inline void SpectrumFifo::finishWrite()
+{
+	mWriteIndex.store(mWriteIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+inline void SpectrumFifo::skipWrite()
+{
+	mNextSequence++;
+	mOverruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline const SpectrumFrame* SpectrumFifo::beginRead()
+{
+	auto readIndex = mReadIndex.load(std::memory_order_relaxed);
+	if (readIndex == mWriteIndex.load(std::memory_order_acquire))
+		return nullptr;
+
+	return &mFrames[readIndex & mMask];
+}
+
+inline const SpectrumFrame* SpectrumFifo::beginReadLatest()
+{
+	auto readIndex = mReadIndex.load(std::memory_order_relaxed);
+	auto writeIndex = mWriteIndex.load(std::memory_order_acquire);
+	if (readIndex == writeIndex)
+		return nullptr;
+
+	// --- hand the skipped slots back to the producer, the newest stays reserved until finishRead
+	auto skipped = writeIndex - readIndex - 1;
+	if (skipped > 0)
+	{
+		mDropped.fetch_add(skipped, std::memory_order_relaxed);
+		mReadIndex.store(writeIndex - 1, std::memory_order_release);
+	}
+
+	return &mFrames[(writeIndex - 1) & mMask];
+}
+
+inline void SpectrumFifo::finishRead()
+{
+	mReadIndex.store(mReadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+inline int SpectrumFifo::getNumReady() const
+{
+	return (int)(mWriteIndex.load(std::memory_order_acquire) - mReadIndex.load(std::memory_order_acquire));
+}
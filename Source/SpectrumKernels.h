@@ -0,0 +1,608 @@
+/*
+  ==============================================================================
+
+    SpectrumKernels.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+
+// --- pick the widest instruction set the compiler targets, define SPECTRUM_KERNELS_SCALAR to force plain C++
+//     or SPECTRUM_KERNELS_NO_AVX2 to stop at SSE2
+#if !defined (SPECTRUM_KERNELS_SCALAR)
+ #if defined (__AVX2__) && !defined (SPECTRUM_KERNELS_NO_AVX2)
+  #define SPECTRUM_KERNELS_AVX2 1
+  #include <immintrin.h>
+ #elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SPECTRUM_KERNELS_SSE2 1
+  #include <emmintrin.h>
+ #elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+  #define SPECTRUM_KERNELS_NEON 1
+  #include <arm_neon.h>
+ #endif
+#endif
+
+#if SPECTRUM_KERNELS_NEON && (defined (__aarch64__) || defined (_M_ARM64))
+ #define SPECTRUM_KERNELS_NEON_DOUBLE 1
+#endif
+
+//==============================================================================
+/**
+	Whole-array kernels for the spectrum pipeline.
+
+	- squaredMagnitude: scale * (re^2 + im^2) of interleaved complex bins.
+	- smooth: one-pole average, state moves towards the input with the attack
+	  coefficient when the input is above it and with release otherwise
+	  (coefficient 1 = no smoothing).
+	- complexDot: sum of a[i] * b[i] over complex arrays, the row product of a
+	  sparse spectral kernel.
+	- slidingAccumulate: one input sample into a bank of sliding DFT bins, the
+	  running sums take difference * phasor and the fresh sums sample * phasor,
+	  all four kept as separate real and imaginary arrays.
+	- complexRotate: value[i] *= step[i] over split real and imaginary arrays,
+	  advances the phasors of a sliding DFT by one sample.
+	- widenToDouble, narrowToFloat: float power to double and back, the ends
+	  of a long-term average.
+	- blendDouble: state += coefficient * (input - state) with a double state
+	  and float input, a running mean when the coefficient is 1 / count.
+	- maximumDouble: state = max(state, input), same types.
+	- powerToDecibels: 10 * log10(power) - offset. log2 is taken from the float
+	  exponent plus a 4-term atanh series on the mantissa reduced to
+	  [sqrt(0.5), sqrt(2)); log2 is within 4e-6 of the exact value, which puts
+	  the result within 2e-5 dB between -120 and +20 dB (float rounding of the
+	  output dominates beyond that). Power is clamped to minPower first, so
+	  zeros give a finite floor.
+
+	Each kernel has AVX2, SSE2 and NEON paths with the same maths as the scalar
+	fallback, which also handles the tail that does not fill a vector. The
+	double kernels only take the NEON path on 64-bit ARM, 32-bit NEON has no
+	double lanes.
+
+	The bench tool builds the header once per instruction set, each copy in a
+	namespace of its own given by SPECTRUM_KERNELS_NAMESPACE.
+*/
+#ifndef SPECTRUM_KERNELS_NAMESPACE
+ #define SPECTRUM_KERNELS_NAMESPACE SpectrumKernels
+#endif
+
+namespace SPECTRUM_KERNELS_NAMESPACE
+{
+	// --- atanh series coefficients for log2(m) = 2 / ln(2) * atanh((m - 1) / (m + 1))
+	static constexpr float log2C1 = 2.8853900817779268f;
+	static constexpr float log2C3 = 0.9617966939259756f;
+	static constexpr float log2C5 = 0.5770780163555854f;
+	static constexpr float log2C7 = 0.4121985831111324f;
+	// --- 10 * log10(2)
+	static constexpr float decibelsPerOctave = 3.0102999566398120f;
+
+	inline float fastLog2(float x)
+	{
+		uint32_t bits;
+		memcpy(&bits, &x, sizeof(bits));
+
+		auto exponent = (int)(bits >> 23) - 127;
+		bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+		float m;
+		memcpy(&m, &bits, sizeof(m));
+		if (m > 1.41421356f)
+		{
+			m *= 0.5f;
+			exponent += 1;
+		}
+
+		auto t = (m - 1.0f) / (m + 1.0f);
+		auto t2 = t * t;
+		return (float)exponent + t * (log2C1 + t2 * (log2C3 + t2 * (log2C5 + t2 * log2C7)));
+	}
+
+	//==============================================================================
+	inline void squaredMagnitude(const std::complex<float>* bins, float* power, int numBins, float scale)
+	{
+		auto* data = reinterpret_cast<const float*>(bins);
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		auto vScale = _mm256_set1_ps(scale);
+		for (; i + 8 <= numBins; i += 8)
+		{
+			auto a = _mm256_loadu_ps(data + 2 * i);
+			auto b = _mm256_loadu_ps(data + 2 * i + 8);
+			// --- shuffle works per 128-bit lane, permute restores bin order afterwards
+			auto re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+			auto im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+			auto p = _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im));
+			p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p), _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm256_storeu_ps(power + i, _mm256_mul_ps(p, vScale));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto vScale = _mm_set1_ps(scale);
+		for (; i + 4 <= numBins; i += 4)
+		{
+			auto a = _mm_loadu_ps(data + 2 * i);
+			auto b = _mm_loadu_ps(data + 2 * i + 4);
+			auto re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+			auto im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+			auto p = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+			_mm_storeu_ps(power + i, _mm_mul_ps(p, vScale));
+		}
+#elif SPECTRUM_KERNELS_NEON
+		auto vScale = vdupq_n_f32(scale);
+		for (; i + 4 <= numBins; i += 4)
+		{
+			auto v = vld2q_f32(data + 2 * i);
+			auto p = vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]);
+			vst1q_f32(power + i, vmulq_f32(p, vScale));
+		}
+#endif
+
+		for (; i < numBins; i++)
+		{
+			auto re = data[2 * i];
+			auto im = data[2 * i + 1];
+			power[i] = scale * (re * re + im * im);
+		}
+	}
+
+	//==============================================================================
+	inline std::complex<float> complexDot(const std::complex<float>* a, const std::complex<float>* b, int n)
+	{
+		auto* x = reinterpret_cast<const float*>(a);
+		auto* y = reinterpret_cast<const float*>(b);
+		float re = 0.0f;
+		float im = 0.0f;
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		// --- direct holds ar * br, ai * bi pairs, crossed ar * bi, ai * br, folded into re and im at the end
+		auto direct = _mm256_setzero_ps();
+		auto crossed = _mm256_setzero_ps();
+		for (; i + 4 <= n; i += 4)
+		{
+			auto va = _mm256_loadu_ps(x + 2 * i);
+			auto vb = _mm256_loadu_ps(y + 2 * i);
+			direct = _mm256_add_ps(direct, _mm256_mul_ps(va, vb));
+			crossed = _mm256_add_ps(crossed, _mm256_mul_ps(va, _mm256_permute_ps(vb, _MM_SHUFFLE(2, 3, 0, 1))));
+		}
+		float d[8], c[8];
+		_mm256_storeu_ps(d, direct);
+		_mm256_storeu_ps(c, crossed);
+		for (int j = 0; j < 8; j += 2)
+		{
+			re += d[j] - d[j + 1];
+			im += c[j] + c[j + 1];
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto direct = _mm_setzero_ps();
+		auto crossed = _mm_setzero_ps();
+		for (; i + 2 <= n; i += 2)
+		{
+			auto va = _mm_loadu_ps(x + 2 * i);
+			auto vb = _mm_loadu_ps(y + 2 * i);
+			direct = _mm_add_ps(direct, _mm_mul_ps(va, vb));
+			crossed = _mm_add_ps(crossed, _mm_mul_ps(va, _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1))));
+		}
+		float d[4], c[4];
+		_mm_storeu_ps(d, direct);
+		_mm_storeu_ps(c, crossed);
+		re = d[0] - d[1] + d[2] - d[3];
+		im = c[0] + c[1] + c[2] + c[3];
+#elif SPECTRUM_KERNELS_NEON
+		auto vRe = vdupq_n_f32(0.0f);
+		auto vIm = vdupq_n_f32(0.0f);
+		for (; i + 4 <= n; i += 4)
+		{
+			auto va = vld2q_f32(x + 2 * i);
+			auto vb = vld2q_f32(y + 2 * i);
+			vRe = vmlsq_f32(vmlaq_f32(vRe, va.val[0], vb.val[0]), va.val[1], vb.val[1]);
+			vIm = vmlaq_f32(vmlaq_f32(vIm, va.val[0], vb.val[1]), va.val[1], vb.val[0]);
+		}
+		float r[4], m[4];
+		vst1q_f32(r, vRe);
+		vst1q_f32(m, vIm);
+		re = r[0] + r[1] + r[2] + r[3];
+		im = m[0] + m[1] + m[2] + m[3];
+#endif
+
+		for (; i < n; i++)
+		{
+			re += x[2 * i] * y[2 * i] - x[2 * i + 1] * y[2 * i + 1];
+			im += x[2 * i] * y[2 * i + 1] + x[2 * i + 1] * y[2 * i];
+		}
+		return std::complex<float>(re, im);
+	}
+
+	//==============================================================================
+	inline void slidingAccumulate(float* sumRe, float* sumIm, float* freshRe, float* freshIm,
+		const float* phasorRe, const float* phasorIm, float difference, float sample, int n)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		auto vDifference = _mm256_set1_ps(difference);
+		auto vSample = _mm256_set1_ps(sample);
+		for (; i + 8 <= n; i += 8)
+		{
+			auto pr = _mm256_loadu_ps(phasorRe + i);
+			auto pi = _mm256_loadu_ps(phasorIm + i);
+			_mm256_storeu_ps(sumRe + i, _mm256_add_ps(_mm256_loadu_ps(sumRe + i), _mm256_mul_ps(vDifference, pr)));
+			_mm256_storeu_ps(sumIm + i, _mm256_add_ps(_mm256_loadu_ps(sumIm + i), _mm256_mul_ps(vDifference, pi)));
+			_mm256_storeu_ps(freshRe + i, _mm256_add_ps(_mm256_loadu_ps(freshRe + i), _mm256_mul_ps(vSample, pr)));
+			_mm256_storeu_ps(freshIm + i, _mm256_add_ps(_mm256_loadu_ps(freshIm + i), _mm256_mul_ps(vSample, pi)));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto vDifference = _mm_set1_ps(difference);
+		auto vSample = _mm_set1_ps(sample);
+		for (; i + 4 <= n; i += 4)
+		{
+			auto pr = _mm_loadu_ps(phasorRe + i);
+			auto pi = _mm_loadu_ps(phasorIm + i);
+			_mm_storeu_ps(sumRe + i, _mm_add_ps(_mm_loadu_ps(sumRe + i), _mm_mul_ps(vDifference, pr)));
+			_mm_storeu_ps(sumIm + i, _mm_add_ps(_mm_loadu_ps(sumIm + i), _mm_mul_ps(vDifference, pi)));
+			_mm_storeu_ps(freshRe + i, _mm_add_ps(_mm_loadu_ps(freshRe + i), _mm_mul_ps(vSample, pr)));
+			_mm_storeu_ps(freshIm + i, _mm_add_ps(_mm_loadu_ps(freshIm + i), _mm_mul_ps(vSample, pi)));
+		}
+#elif SPECTRUM_KERNELS_NEON
+		for (; i + 4 <= n; i += 4)
+		{
+			auto pr = vld1q_f32(phasorRe + i);
+			auto pi = vld1q_f32(phasorIm + i);
+			vst1q_f32(sumRe + i, vmlaq_n_f32(vld1q_f32(sumRe + i), pr, difference));
+			vst1q_f32(sumIm + i, vmlaq_n_f32(vld1q_f32(sumIm + i), pi, difference));
+			vst1q_f32(freshRe + i, vmlaq_n_f32(vld1q_f32(freshRe + i), pr, sample));
+			vst1q_f32(freshIm + i, vmlaq_n_f32(vld1q_f32(freshIm + i), pi, sample));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			sumRe[i] += difference * phasorRe[i];
+			sumIm[i] += difference * phasorIm[i];
+			freshRe[i] += sample * phasorRe[i];
+			freshIm[i] += sample * phasorIm[i];
+		}
+	}
+
+	//==============================================================================
+	inline void complexRotate(float* re, float* im, const float* stepRe, const float* stepIm, int n)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		for (; i + 8 <= n; i += 8)
+		{
+			auto a = _mm256_loadu_ps(re + i);
+			auto b = _mm256_loadu_ps(im + i);
+			auto c = _mm256_loadu_ps(stepRe + i);
+			auto d = _mm256_loadu_ps(stepIm + i);
+			_mm256_storeu_ps(re + i, _mm256_sub_ps(_mm256_mul_ps(a, c), _mm256_mul_ps(b, d)));
+			_mm256_storeu_ps(im + i, _mm256_add_ps(_mm256_mul_ps(a, d), _mm256_mul_ps(b, c)));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		for (; i + 4 <= n; i += 4)
+		{
+			auto a = _mm_loadu_ps(re + i);
+			auto b = _mm_loadu_ps(im + i);
+			auto c = _mm_loadu_ps(stepRe + i);
+			auto d = _mm_loadu_ps(stepIm + i);
+			_mm_storeu_ps(re + i, _mm_sub_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d)));
+			_mm_storeu_ps(im + i, _mm_add_ps(_mm_mul_ps(a, d), _mm_mul_ps(b, c)));
+		}
+#elif SPECTRUM_KERNELS_NEON
+		for (; i + 4 <= n; i += 4)
+		{
+			auto a = vld1q_f32(re + i);
+			auto b = vld1q_f32(im + i);
+			auto c = vld1q_f32(stepRe + i);
+			auto d = vld1q_f32(stepIm + i);
+			vst1q_f32(re + i, vmlsq_f32(vmulq_f32(a, c), b, d));
+			vst1q_f32(im + i, vmlaq_f32(vmulq_f32(a, d), b, c));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			auto a = re[i];
+			auto b = im[i];
+			re[i] = a * stepRe[i] - b * stepIm[i];
+			im[i] = a * stepIm[i] + b * stepRe[i];
+		}
+	}
+
+	//==============================================================================
+	inline void smooth(float* state, const float* input, int numValues, float attack, float release)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		auto vAttack = _mm256_set1_ps(attack);
+		auto vRelease = _mm256_set1_ps(release);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			auto s = _mm256_loadu_ps(state + i);
+			auto x = _mm256_loadu_ps(input + i);
+			auto coefficient = _mm256_blendv_ps(vRelease, vAttack, _mm256_cmp_ps(x, s, _CMP_GT_OQ));
+			_mm256_storeu_ps(state + i, _mm256_add_ps(s, _mm256_mul_ps(coefficient, _mm256_sub_ps(x, s))));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto vAttack = _mm_set1_ps(attack);
+		auto vRelease = _mm_set1_ps(release);
+		for (; i + 4 <= numValues; i += 4)
+		{
+			auto s = _mm_loadu_ps(state + i);
+			auto x = _mm_loadu_ps(input + i);
+			auto rising = _mm_cmpgt_ps(x, s);
+			auto coefficient = _mm_or_ps(_mm_and_ps(rising, vAttack), _mm_andnot_ps(rising, vRelease));
+			_mm_storeu_ps(state + i, _mm_add_ps(s, _mm_mul_ps(coefficient, _mm_sub_ps(x, s))));
+		}
+#elif SPECTRUM_KERNELS_NEON
+		auto vAttack = vdupq_n_f32(attack);
+		auto vRelease = vdupq_n_f32(release);
+		for (; i + 4 <= numValues; i += 4)
+		{
+			auto s = vld1q_f32(state + i);
+			auto x = vld1q_f32(input + i);
+			auto coefficient = vbslq_f32(vcgtq_f32(x, s), vAttack, vRelease);
+			vst1q_f32(state + i, vmlaq_f32(s, coefficient, vsubq_f32(x, s)));
+		}
+#endif
+
+		for (; i < numValues; i++)
+		{
+			auto coefficient = input[i] > state[i] ? attack : release;
+			state[i] += coefficient * (input[i] - state[i]);
+		}
+	}
+
+	//==============================================================================
+	inline void widenToDouble(const float* input, double* output, int n)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		for (; i + 4 <= n; i += 4)
+		{
+			_mm256_storeu_pd(output + i, _mm256_cvtps_pd(_mm_loadu_ps(input + i)));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = _mm_loadu_ps(input + i);
+			_mm_storeu_pd(output + i, _mm_cvtps_pd(x));
+			_mm_storeu_pd(output + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+		}
+#elif SPECTRUM_KERNELS_NEON_DOUBLE
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = vld1q_f32(input + i);
+			vst1q_f64(output + i, vcvt_f64_f32(vget_low_f32(x)));
+			vst1q_f64(output + i + 2, vcvt_high_f64_f32(x));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			output[i] = (double)input[i];
+		}
+	}
+
+	//==============================================================================
+	inline void narrowToFloat(const double* input, float* output, int n)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		for (; i + 4 <= n; i += 4)
+		{
+			_mm_storeu_ps(output + i, _mm256_cvtpd_ps(_mm256_loadu_pd(input + i)));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		for (; i + 4 <= n; i += 4)
+		{
+			auto low = _mm_cvtpd_ps(_mm_loadu_pd(input + i));
+			auto high = _mm_cvtpd_ps(_mm_loadu_pd(input + i + 2));
+			_mm_storeu_ps(output + i, _mm_movelh_ps(low, high));
+		}
+#elif SPECTRUM_KERNELS_NEON_DOUBLE
+		for (; i + 4 <= n; i += 4)
+		{
+			auto low = vcvt_f32_f64(vld1q_f64(input + i));
+			vst1q_f32(output + i, vcvt_high_f32_f64(low, vld1q_f64(input + i + 2)));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			output[i] = (float)input[i];
+		}
+	}
+
+	//==============================================================================
+	inline void blendDouble(double* state, const float* input, int n, double coefficient)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		auto vCoefficient = _mm256_set1_pd(coefficient);
+		for (; i + 4 <= n; i += 4)
+		{
+			auto s = _mm256_loadu_pd(state + i);
+			auto x = _mm256_cvtps_pd(_mm_loadu_ps(input + i));
+			_mm256_storeu_pd(state + i, _mm256_add_pd(s, _mm256_mul_pd(vCoefficient, _mm256_sub_pd(x, s))));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto vCoefficient = _mm_set1_pd(coefficient);
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = _mm_loadu_ps(input + i);
+			auto s0 = _mm_loadu_pd(state + i);
+			auto s1 = _mm_loadu_pd(state + i + 2);
+			auto x0 = _mm_cvtps_pd(x);
+			auto x1 = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+			_mm_storeu_pd(state + i, _mm_add_pd(s0, _mm_mul_pd(vCoefficient, _mm_sub_pd(x0, s0))));
+			_mm_storeu_pd(state + i + 2, _mm_add_pd(s1, _mm_mul_pd(vCoefficient, _mm_sub_pd(x1, s1))));
+		}
+#elif SPECTRUM_KERNELS_NEON_DOUBLE
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = vld1q_f32(input + i);
+			auto s0 = vld1q_f64(state + i);
+			auto s1 = vld1q_f64(state + i + 2);
+			vst1q_f64(state + i, vaddq_f64(s0, vmulq_n_f64(vsubq_f64(vcvt_f64_f32(vget_low_f32(x)), s0), coefficient)));
+			vst1q_f64(state + i + 2, vaddq_f64(s1, vmulq_n_f64(vsubq_f64(vcvt_high_f64_f32(x), s1), coefficient)));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			state[i] += coefficient * ((double)input[i] - state[i]);
+		}
+	}
+
+	//==============================================================================
+	inline void maximumDouble(double* state, const float* input, int n)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = _mm256_cvtps_pd(_mm_loadu_ps(input + i));
+			_mm256_storeu_pd(state + i, _mm256_max_pd(_mm256_loadu_pd(state + i), x));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = _mm_loadu_ps(input + i);
+			_mm_storeu_pd(state + i, _mm_max_pd(_mm_loadu_pd(state + i), _mm_cvtps_pd(x)));
+			_mm_storeu_pd(state + i + 2, _mm_max_pd(_mm_loadu_pd(state + i + 2), _mm_cvtps_pd(_mm_movehl_ps(x, x))));
+		}
+#elif SPECTRUM_KERNELS_NEON_DOUBLE
+		for (; i + 4 <= n; i += 4)
+		{
+			auto x = vld1q_f32(input + i);
+			vst1q_f64(state + i, vmaxq_f64(vld1q_f64(state + i), vcvt_f64_f32(vget_low_f32(x))));
+			vst1q_f64(state + i + 2, vmaxq_f64(vld1q_f64(state + i + 2), vcvt_high_f64_f32(x)));
+		}
+#endif
+
+		for (; i < n; i++)
+		{
+			auto x = (double)input[i];
+			state[i] = state[i] > x ? state[i] : x;
+		}
+	}
+
+	//==============================================================================
+	inline void powerToDecibels(const float* power, float* decibels, int numValues, float offsetdB, float minPower)
+	{
+		int i = 0;
+
+#if SPECTRUM_KERNELS_AVX2
+		auto vMin = _mm256_set1_ps(minPower);
+		auto vOffset = _mm256_set1_ps(offsetdB);
+		auto vScale = _mm256_set1_ps(decibelsPerOctave);
+		auto vOne = _mm256_set1_ps(1.0f);
+		auto vHalf = _mm256_set1_ps(0.5f);
+		auto vSqrt2 = _mm256_set1_ps(1.41421356f);
+		auto vMantissaMask = _mm256_set1_epi32(0x007fffff);
+		auto vExponentOne = _mm256_set1_epi32(0x3f800000);
+		for (; i + 8 <= numValues; i += 8)
+		{
+			auto x = _mm256_max_ps(_mm256_loadu_ps(power + i), vMin);
+			auto bits = _mm256_castps_si256(x);
+			auto exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+			auto m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, vMantissaMask), vExponentOne));
+
+			auto high = _mm256_cmp_ps(m, vSqrt2, _CMP_GT_OQ);
+			m = _mm256_blendv_ps(m, _mm256_mul_ps(m, vHalf), high);
+			exponent = _mm256_sub_epi32(exponent, _mm256_castps_si256(high));
+
+			auto t = _mm256_div_ps(_mm256_sub_ps(m, vOne), _mm256_add_ps(m, vOne));
+			auto t2 = _mm256_mul_ps(t, t);
+			auto p = _mm256_add_ps(_mm256_set1_ps(log2C5), _mm256_mul_ps(t2, _mm256_set1_ps(log2C7)));
+			p = _mm256_add_ps(_mm256_set1_ps(log2C3), _mm256_mul_ps(t2, p));
+			p = _mm256_add_ps(_mm256_set1_ps(log2C1), _mm256_mul_ps(t2, p));
+			auto log2x = _mm256_add_ps(_mm256_cvtepi32_ps(exponent), _mm256_mul_ps(t, p));
+
+			_mm256_storeu_ps(decibels + i, _mm256_sub_ps(_mm256_mul_ps(log2x, vScale), vOffset));
+		}
+#elif SPECTRUM_KERNELS_SSE2
+		auto vMin = _mm_set1_ps(minPower);
+		auto vOffset = _mm_set1_ps(offsetdB);
+		auto vScale = _mm_set1_ps(decibelsPerOctave);
+		auto vOne = _mm_set1_ps(1.0f);
+		auto vHalf = _mm_set1_ps(0.5f);
+		auto vSqrt2 = _mm_set1_ps(1.41421356f);
+		auto vMantissaMask = _mm_set1_epi32(0x007fffff);
+		auto vExponentOne = _mm_set1_epi32(0x3f800000);
+		for (; i + 4 <= numValues; i += 4)
+		{
+			auto x = _mm_max_ps(_mm_loadu_ps(power + i), vMin);
+			auto bits = _mm_castps_si128(x);
+			auto exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+			auto m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, vMantissaMask), vExponentOne));
+
+			// --- mask is all ones (-1) where the mantissa gets halved, so subtracting it bumps the exponent
+			auto high = _mm_cmpgt_ps(m, vSqrt2);
+			m = _mm_or_ps(_mm_and_ps(high, _mm_mul_ps(m, vHalf)), _mm_andnot_ps(high, m));
+			exponent = _mm_sub_epi32(exponent, _mm_castps_si128(high));
+
+			auto t = _mm_div_ps(_mm_sub_ps(m, vOne), _mm_add_ps(m, vOne));
+			auto t2 = _mm_mul_ps(t, t);
+			auto p = _mm_add_ps(_mm_set1_ps(log2C5), _mm_mul_ps(t2, _mm_set1_ps(log2C7)));
+			p = _mm_add_ps(_mm_set1_ps(log2C3), _mm_mul_ps(t2, p));
+			p = _mm_add_ps(_mm_set1_ps(log2C1), _mm_mul_ps(t2, p));
+			auto log2x = _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_mul_ps(t, p));
+
+			_mm_storeu_ps(decibels + i, _mm_sub_ps(_mm_mul_ps(log2x, vScale), vOffset));
+		}
+#elif SPECTRUM_KERNELS_NEON
+		auto vMin = vdupq_n_f32(minPower);
+		auto vOffset = vdupq_n_f32(offsetdB);
+		auto vScale = vdupq_n_f32(decibelsPerOctave);
+		auto vOne = vdupq_n_f32(1.0f);
+		auto vSqrt2 = vdupq_n_f32(1.41421356f);
+		for (; i + 4 <= numValues; i += 4)
+		{
+			auto x = vmaxq_f32(vld1q_f32(power + i), vMin);
+			auto bits = vreinterpretq_u32_f32(x);
+			auto exponent = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127));
+			auto m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+
+			auto high = vcgtq_f32(m, vSqrt2);
+			m = vbslq_f32(high, vmulq_n_f32(m, 0.5f), m);
+			exponent = vsubq_s32(exponent, vreinterpretq_s32_u32(high));
+
+			auto numerator = vsubq_f32(m, vOne);
+			auto denominator = vaddq_f32(m, vOne);
+			// --- reciprocal estimate plus two Newton steps, plenty for the series
+			auto reciprocal = vrecpeq_f32(denominator);
+			reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+			reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+			auto t = vmulq_f32(numerator, reciprocal);
+			auto t2 = vmulq_f32(t, t);
+			auto p = vmlaq_f32(vdupq_n_f32(log2C5), t2, vdupq_n_f32(log2C7));
+			p = vmlaq_f32(vdupq_n_f32(log2C3), t2, p);
+			p = vmlaq_f32(vdupq_n_f32(log2C1), t2, p);
+			auto log2x = vmlaq_f32(vcvtq_f32_s32(exponent), t, p);
+
+			vst1q_f32(decibels + i, vsubq_f32(vmulq_f32(log2x, vScale), vOffset));
+		}
+#endif
+
+		for (; i < numValues; i++)
+		{
+			auto x = power[i] > minPower ? power[i] : minPower;
+			decibels[i] = fastLog2(x) * decibelsPerOctave - offsetdB;
+		}
+	}
+}
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    WindowTable.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <memory>
+#include <cstdint>
+
+// --- ids match the window function combo box in the editor
+enum WindowType
+{
+	kRectangular = 1,
+	kHanning,
+	kHamming,
+	kBlackman,
+	kTriangle,
+	kKaiser,
+	kFlatTop,
+	kBlackmanHarris,
+	kGaussian,
+	kNumWindowTypes = kGaussian
+};
+
+//==============================================================================
+/**
+	Holds every analysis window for one transform size, computed once in double
+	precision and stored as float rows aligned for SIMD multiplies.
+
+	Coherent gain is the mean of the window (the amplitude loss of a bin-centred
+	sinusoid), ENBW is the equivalent noise bandwidth in bins.
+*/
+class WindowTable
+{
+public:
+	WindowTable()
+	{
+		mSize = 0;
+		mTable = nullptr;
+	};
+
+	~WindowTable()
+	{
+	};
+
+	void createWindowTable(unsigned int size);
+
+	int getSize() const { return mSize; }
+	const float* getWindow(int tag) const { return mTable + (size_t)(clampTag(tag) - 1) * mSize; }
+	float getCoherentGain(int tag) const { return mCoherentGain[clampTag(tag) - 1]; }
+	float getENBW(int tag) const { return mENBW[clampTag(tag) - 1]; }
+
+	static double getWindowValue(int tag, int i, int size);
+	// --- amplitude response offset bins away from the centre of the main lobe, 1 at offset 0
+	static double getScallopingGain(int tag, double offset);
+
+private:
+	static int clampTag(int tag) { return tag < 1 ? 1 : (tag > kNumWindowTypes ? kNumWindowTypes : tag); }
+	static double besselI0(double x);
+
+	static constexpr size_t alignment = 64;
+
+	std::unique_ptr<char[]> mStorage = nullptr;
+	float* mTable;
+	int mSize;
+	float mCoherentGain[kNumWindowTypes] = {};
+	float mENBW[kNumWindowTypes] = {};
+};
+
+inline void WindowTable::createWindowTable(unsigned int size)
+{
+	mSize = (int)size;
+
+	// --- one row per window type, rows stay aligned as long as size is a multiple of 16
+	auto bytes = sizeof(float) * (size_t)kNumWindowTypes * size;
+	mStorage.reset(new char[bytes + alignment]);
+	auto address = reinterpret_cast<std::uintptr_t>(mStorage.get());
+	mTable = reinterpret_cast<float*>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+
+	for (int tag = 1; tag <= kNumWindowTypes; tag++)
+	{
+		auto* row = mTable + (size_t)(tag - 1) * mSize;
+		double sum = 0.0;
+		double sumOfSquares = 0.0;
+
+		for (int i = 0; i < mSize; i++)
+		{
+			auto w = getWindowValue(tag, i, mSize);
+			row[i] = (float)w;
+			sum += w;
+			sumOfSquares += w * w;
+		}
+
+		mCoherentGain[tag - 1] = (float)(sum / mSize);
+		mENBW[tag - 1] = (float)(mSize * sumOfSquares / (sum * sum));
+	}
+}
+
+inline double WindowTable::getWindowValue(int tag, int i, int size)
+{
+	// --- symmetric windows, same convention as the original per-sample code
+	const double n = size - 1;
+	const double x = 2.0 * M_PI * i / n;
+
+	switch (clampTag(tag))
+	{
+	case kHanning:
+		return 0.5 * (1.0 - cos(x));
+	case kHamming:
+		return 0.54 - 0.46 * cos(x);
+	case kBlackman:
+		return 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+	case kTriangle:
+		return 1.0 - fabs(2.0 * i / n - 1.0);
+	case kKaiser:
+	{
+		// --- beta = 9 gives roughly -90dB side lobes
+		const double beta = 9.0;
+		auto r = 2.0 * i / n - 1.0;
+		return besselI0(beta * sqrt(1.0 - r * r)) / besselI0(beta);
+	}
+	case kFlatTop:
+		return 0.21557895 - 0.41663158 * cos(x) + 0.277263158 * cos(2.0 * x)
+			- 0.083578947 * cos(3.0 * x) + 0.006947368 * cos(4.0 * x);
+	case kBlackmanHarris:
+		return 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+	case kGaussian:
+	{
+		const double sigma = 0.4;
+		auto r = (i - n * 0.5) / (sigma * n * 0.5);
+		return exp(-0.5 * r * r);
+	}
+	case kRectangular:
+	default:
+		return 1.0;
+	}
+}
+
+inline double WindowTable::getScallopingGain(int tag, double offset)
+{
+	// --- the main lobe shape barely depends on the size, a short window is plenty
+	const int size = 256;
+	double sum = 0.0;
+	double re = 0.0;
+	double im = 0.0;
+
+	for (int i = 0; i < size; i++)
+	{
+		auto w = getWindowValue(tag, i, size);
+		auto phase = 2.0 * M_PI * offset * i / size;
+		sum += w;
+		re += w * cos(phase);
+		im -= w * sin(phase);
+	}
+	return sqrt(re * re + im * im) / sum;
+}
+
+inline double WindowTable::besselI0(double x)
+{
+	// --- power series, converges quickly for the beta range used here
+	double sum = 1.0;
+	double term = 1.0;
+	auto halfX = x * 0.5;
+
+	for (int k = 1; k < 50; k++)
+	{
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
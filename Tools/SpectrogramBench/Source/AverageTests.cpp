@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    AverageTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "SpectrumAverage.h"
+
+//==============================================================================
+// every mode against the same recurrence worked out in double per value, and the resets that
+// keep one mode's state from leaking into another
+class SpectrumAverageTests : public juce::UnitTest
+{
+public:
+	SpectrumAverageTests() : juce::UnitTest("Spectrum average", "Tests") {}
+
+	void runTest() override
+	{
+		beginTest("linear is the mean of every frame");
+		checkLinear();
+
+		beginTest("exponential starts linear and then fades with its time constant");
+		checkExponential();
+
+		beginTest("peak hold keeps the highest value");
+		checkPeakHold();
+
+		beginTest("a change of mode or size starts again");
+		checkResets();
+	}
+
+private:
+	// --- odd, so every kernel's vector loop and its scalar tail are used
+	static constexpr int numValues = 37;
+	static constexpr int numFrames = 2000;
+	static constexpr double frameSeconds = 0.01;
+
+	std::vector<float> createFrame()
+	{
+		std::vector<float> frame((size_t)numValues);
+		for (auto& value : frame)
+			value = getRandom().nextFloat() * 10.0f;
+		return frame;
+	}
+
+	// --- worst relative difference between the snapshot and a double reference
+	double compare(const SpectrumAverage& average, const std::vector<double>& expected)
+	{
+		std::vector<float> snapshot((size_t)numValues);
+		expect(average.getSnapshot(snapshot.data()), "no snapshot");
+		auto worst = 0.0;
+		for (int i = 0; i < numValues; i++)
+			worst = juce::jmax(worst, std::abs(snapshot[(size_t)i] - expected[(size_t)i]) / expected[(size_t)i]);
+		return worst;
+	}
+
+	void checkLinear()
+	{
+		SpectrumAverage average;
+		average.createSpectrumAverage(64);
+		std::vector<double> sum((size_t)numValues, 0.0);
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			auto power = createFrame();
+			average.addFrame(power.data(), numValues, kAverageLinear, 0.0, frameSeconds);
+			for (int i = 0; i < numValues; i++)
+				sum[(size_t)i] += power[(size_t)i];
+		}
+
+		std::vector<double> expected((size_t)numValues);
+		for (int i = 0; i < numValues; i++)
+			expected[(size_t)i] = sum[(size_t)i] / numFrames;
+		auto worst = compare(average, expected);
+		expect(worst < 1.0e-6, "relative error " + juce::String(worst));
+		expectEquals((int)average.getNumFrames(), numFrames);
+		expectWithinAbsoluteError(average.getSeconds(), numFrames * frameSeconds, 1.0e-9);
+	}
+
+	void checkExponential()
+	{
+		auto timeConstant = 1.0;
+		SpectrumAverage average;
+		average.createSpectrumAverage(64);
+		std::vector<double> expected((size_t)numValues, 0.0);
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			auto power = createFrame();
+			average.addFrame(power.data(), numValues, kAverageExponential, timeConstant, frameSeconds);
+			auto coefficient = juce::jmax(1.0 / (frame + 1), 1.0 - std::exp(-frameSeconds / timeConstant));
+			for (int i = 0; i < numValues; i++)
+				expected[(size_t)i] += coefficient * (power[(size_t)i] - expected[(size_t)i]);
+		}
+		auto worst = compare(average, expected);
+		expect(worst < 1.0e-6, "relative error " + juce::String(worst));
+
+		// --- after a step from 1 to 2 the average has covered 1 - 1 / e of it one time constant later
+		std::vector<float> ones((size_t)numValues, 1.0f), twos((size_t)numValues, 2.0f);
+		for (int frame = 0; frame < numFrames; frame++)
+			average.addFrame(ones.data(), numValues, kAverageExponential, timeConstant, frameSeconds);
+		for (int frame = 0; frame < juce::roundToInt(timeConstant / frameSeconds); frame++)
+			average.addFrame(twos.data(), numValues, kAverageExponential, timeConstant, frameSeconds);
+		std::vector<float> snapshot((size_t)numValues);
+		average.getSnapshot(snapshot.data());
+		expectWithinAbsoluteError((double)snapshot[0], 2.0 - std::exp(-1.0), 1.0e-4);
+	}
+
+	void checkPeakHold()
+	{
+		SpectrumAverage average;
+		average.createSpectrumAverage(64);
+		std::vector<double> expected((size_t)numValues, 0.0);
+		for (int frame = 0; frame < numFrames; frame++)
+		{
+			auto power = createFrame();
+			average.addFrame(power.data(), numValues, kAveragePeakHold, 0.0, frameSeconds);
+			for (int i = 0; i < numValues; i++)
+				expected[(size_t)i] = juce::jmax(expected[(size_t)i], (double)power[(size_t)i]);
+		}
+		expect(compare(average, expected) == 0.0, "a peak was lost");
+	}
+
+	void checkResets()
+	{
+		SpectrumAverage average;
+		average.createSpectrumAverage(64);
+		std::vector<float> snapshot((size_t)numValues);
+		expect(!average.getSnapshot(snapshot.data()), "snapshot before the first frame");
+
+		auto high = createFrame();
+		for (auto& value : high)
+			value += 100.0f;
+		average.addFrame(high.data(), numValues, kAveragePeakHold, 0.0, frameSeconds);
+
+		// --- the peaks must not carry over into the mean
+		auto power = createFrame();
+		average.addFrame(power.data(), numValues, kAverageLinear, 0.0, frameSeconds);
+		expectEquals((int)average.getNumFrames(), 1);
+		expectWithinAbsoluteError(average.getSeconds(), frameSeconds, 1.0e-12);
+		average.getSnapshot(snapshot.data());
+		expect(snapshot == power, "the peak hold state leaked into the linear mean");
+
+		// --- nor the mean into a shorter frame of the same mode
+		average.addFrame(high.data(), numValues - 1, kAverageLinear, 0.0, frameSeconds);
+		expectEquals((int)average.getNumFrames(), 1);
+		expectEquals(average.getNumValues(), numValues - 1);
+		average.getSnapshot(snapshot.data());
+		expect(std::equal(high.begin(), high.end() - 1, snapshot.begin()), "a size change did not start again");
+
+		average.reset();
+		expect(!average.getSnapshot(snapshot.data()), "snapshot after a reset");
+		average.addFrame(power.data(), numValues - 1, kAverageLinear, 0.0, frameSeconds);
+		average.getSnapshot(snapshot.data());
+		expect(std::equal(power.begin(), power.end() - 1, snapshot.begin()), "the state before the reset was blended in");
+	}
+};
+
+static SpectrumAverageTests spectrumAverageTests;
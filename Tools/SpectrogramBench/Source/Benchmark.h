@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// nanoseconds per call of function, the best of numRuns runs of numCalls calls each,
+// the fastest run is the one the rest of the machine disturbed least
+template <typename Function>
+double measureNanoseconds(Function&& function, int numCalls, int numRuns = 7)
+{
+	// --- one untimed run to warm the caches and the branch predictors
+	for (int call = 0; call < numCalls; call++)
+		function();
+
+	auto best = std::numeric_limits<double>::max();
+	for (int run = 0; run < numRuns; run++)
+	{
+		auto start = juce::Time::getHighResolutionTicks();
+		for (int call = 0; call < numCalls; call++)
+			function();
+		auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+		best = juce::jmin(best, seconds * 1.0e9 / numCalls);
+	}
+	return best;
+}
+
+// zeroed floats on a 64 byte boundary, the alignment the pool scratch gives the transforms
+class AlignedFloats
+{
+public:
+	explicit AlignedFloats(int numFloats) : storage((size_t)numFloats * sizeof(float) + alignment, true) {}
+
+	float* get()
+	{
+		auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+		return reinterpret_cast<float*>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+	}
+
+private:
+	static constexpr size_t alignment = 64;
+	juce::HeapBlock<char> storage;
+};
+
+// one line of a results table, the name padded so the columns line up
+inline juce::String formatBenchRow(const juce::String& name, double nanoseconds, double reference)
+{
+	return name.paddedRight(' ', 36) + juce::String(nanoseconds, 1).paddedLeft(' ', 10) + " ns"
+		+ juce::String(reference / nanoseconds, 2).paddedLeft(' ', 8) + "x";
+}
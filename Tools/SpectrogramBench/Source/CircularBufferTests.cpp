@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    CircularBufferTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "CircularBuffer.h"
+
+//==============================================================================
+// the chunked block reads of a mirrored ring have to give what the masked per-sample reads of a
+// plain ring holding the same samples give, around the wrap and at both ends of the delay range
+class CircularBufferTests : public juce::UnitTest
+{
+public:
+	CircularBufferTests() : juce::UnitTest("Circular buffer", "Tests") {}
+
+	void runTest() override
+	{
+		beginTest("mirrored block reads match the plain ring");
+		checkInterpolator<CircularBuffer<float>::kInterpolateLinear>("linear");
+		checkInterpolator<CircularBuffer<float>::kInterpolateHermite>("hermite");
+		checkInterpolator<CircularBuffer<float>::kInterpolateLagrange, 3>("lagrange 3");
+		checkInterpolator<CircularBuffer<float>::kInterpolateLagrange, 7>("lagrange 7");
+		checkInterpolator<CircularBuffer<float>::kInterpolateAllpass>("allpass");
+	}
+
+private:
+	static constexpr int ringLength = 4096;
+	static constexpr int blockSize = 150;
+
+	template <int Interpolation, int Order = 3>
+	void checkInterpolator(const juce::String& name)
+	{
+		CircularBuffer<float> plain, mirrored;
+		plain.createCircularBuffer(ringLength);
+		mirrored.createCircularBuffer(ringLength, true);
+		expect(mirrored.getMirrorMode() != CircularBuffer<float>::kMirrorNone);
+		expectEquals((int)mirrored.getBufferLength(), (int)plain.getBufferLength());
+
+		// --- three delay ranges: well inside the ring, right behind the write position with taps in
+		//     front of it, and out at the far end of the ring
+		const float ranges[][2] = { { 300.0f, 900.0f }, { 0.0f, 3.0f }, { ringLength - blockSize - 8.0f, ringLength - blockSize + 1.0f } };
+
+		auto& random = getRandom();
+		std::vector<float> input(blockSize), delays(blockSize), expected(blockSize), output(blockSize);
+		auto worst = 0.0f;
+		for (int block = 0; block < 3 * ringLength / blockSize; block++)
+		{
+			for (auto& sample : input)
+				sample = random.nextFloat() * 2.0f - 1.0f;
+			plain.writeBuffer(input.data(), blockSize);
+			mirrored.writeBuffer(input.data(), blockSize);
+
+			auto& range = ranges[block % 3];
+			for (auto& delay : delays)
+				delay = range[0] + random.nextFloat() * (range[1] - range[0]);
+
+			// --- the far range only starts to hold real samples once the ring has been filled
+			if (block % 3 == 2 && block * blockSize < ringLength)
+				continue;
+
+			plain.readBuffer<Interpolation, Order>(expected.data(), delays.data(), blockSize);
+			mirrored.readBuffer<Interpolation, Order>(output.data(), delays.data(), blockSize);
+			for (int i = 0; i < blockSize; i++)
+				worst = juce::jmax(worst, std::abs(output[(size_t)i] - expected[(size_t)i]));
+		}
+		expect(worst < 1.0e-5f, name + ", off by " + juce::String(worst));
+	}
+};
+
+static CircularBufferTests circularBufferTests;
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    CompositeTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "SpectrumComposite.h"
+
+//==============================================================================
+// the stitched spectrum has to follow a spectrum every layer agrees on, and where the layers
+// disagree it has to move from one to the next without a step at the crossovers
+class SpectrumCompositeTests : public juce::UnitTest
+{
+public:
+	SpectrumCompositeTests() : juce::UnitTest("Spectrum composite", "Tests") {}
+
+	void runTest() override
+	{
+		beginTest("a smooth spectrum passes unchanged");
+		checkSmoothSpectrum(3, 0);
+		checkSmoothSpectrum(3, 1);
+		checkSmoothSpectrum(2, 0);
+
+		beginTest("crossovers are continuous");
+		checkCrossovers(3);
+		checkCrossovers(2);
+
+		beginTest("tables are only rebuilt on a change");
+		SpectrumComposite composite;
+		int windowSizes[] = { 8192, 2048, 512 };
+		expect(composite.createSpectrumComposite(3, windowSizes, windowSizes, sampleRate));
+		expect(!composite.createSpectrumComposite(3, windowSizes, windowSizes, sampleRate));
+		expect(composite.createSpectrumComposite(2, windowSizes, windowSizes, sampleRate));
+		expect(composite.createSpectrumComposite(2, windowSizes, windowSizes, 2.0 * sampleRate));
+	}
+
+private:
+	static constexpr double sampleRate = 48000.0;
+
+	// --- a pink-ish slope with a broad bump, smooth enough for the short layers' linear interpolation
+	static double getLevel(double frequency)
+	{
+		return 1.0 / (1.0 + frequency / 200.0) + 0.5 * std::exp(-juce::square(std::log2(frequency / 3000.0 + 1.0e-9)));
+	}
+
+	struct Layers
+	{
+		Layers(int numLayers, int paddingOrder)
+		{
+			for (int layer = 0; layer < numLayers; layer++)
+			{
+				windowSizes[layer] = 8192 >> (2 * layer);
+				fftSizes[layer] = windowSizes[layer] << paddingOrder;
+				power[layer].resize((size_t)(fftSizes[layer] / 2 + 1));
+				pointers[layer] = power[layer].data();
+			}
+		}
+
+		int windowSizes[SpectrumComposite::maxNumLayers] = {};
+		int fftSizes[SpectrumComposite::maxNumLayers] = {};
+		std::vector<float> power[SpectrumComposite::maxNumLayers];
+		const float* pointers[SpectrumComposite::maxNumLayers] = {};
+	};
+
+	void checkSmoothSpectrum(int numLayers, int paddingOrder)
+	{
+		Layers layers(numLayers, paddingOrder);
+		float gains[SpectrumComposite::maxNumLayers];
+		for (int layer = 0; layer < numLayers; layer++)
+		{
+			// --- every layer on its own scale, the gains bring them back to layer 0's
+			gains[layer] = (float)(1 << layer);
+			for (size_t k = 0; k < layers.power[layer].size(); k++)
+				layers.power[layer][k] = (float)(getLevel(k * sampleRate / layers.fftSizes[layer]) / gains[layer]);
+		}
+
+		SpectrumComposite composite;
+		composite.createSpectrumComposite(numLayers, layers.windowSizes, layers.fftSizes, sampleRate);
+		std::vector<float> output((size_t)composite.getNumBins());
+		composite.combine(layers.pointers, gains, output.data());
+
+		auto worst = 0.0;
+		for (int k = 1; k < composite.getNumBins(); k++)
+		{
+			auto expected = getLevel(k * sampleRate / layers.fftSizes[0]);
+			worst = juce::jmax(worst, std::abs(output[(size_t)k] / expected - 1.0));
+		}
+		expect(worst < 1.0e-3, juce::String(numLayers) + " layers, relative error " + juce::String(worst));
+	}
+
+	void checkCrossovers(int numLayers)
+	{
+		// --- flat layers, each twice the level of the one before, the output may only rise, and only gradually
+		Layers layers(numLayers, 0);
+		float gains[SpectrumComposite::maxNumLayers];
+		for (int layer = 0; layer < numLayers; layer++)
+		{
+			gains[layer] = 1.0f;
+			std::fill(layers.power[layer].begin(), layers.power[layer].end(), (float)(1 << layer));
+		}
+
+		SpectrumComposite composite;
+		composite.createSpectrumComposite(numLayers, layers.windowSizes, layers.fftSizes, sampleRate);
+		std::vector<float> output((size_t)composite.getNumBins());
+		composite.combine(layers.pointers, gains, output.data());
+
+		auto binWidth = sampleRate / layers.fftSizes[0];
+		auto largestStep = 0.0f;
+		auto isMonotonic = true;
+		for (int k = 1; k < composite.getNumBins(); k++)
+		{
+			auto step = output[(size_t)k] - output[(size_t)k - 1];
+			isMonotonic = isMonotonic && step >= 0.0f;
+			largestStep = juce::jmax(largestStep, step);
+		}
+		expect(isMonotonic, juce::String(numLayers) + " layers, the output falls back somewhere");
+		expect(largestStep < 0.05f, juce::String(numLayers) + " layers, step of " + juce::String(largestStep));
+
+		// --- each layer alone half an octave either side of its crossovers
+		for (int layer = 0; layer < numLayers; layer++)
+		{
+			auto low = layer == 0 ? 0.0 : composite.getCrossover(layer) * std::sqrt(2.0);
+			auto high = layer + 1 < numLayers ? composite.getCrossover(layer + 1) / std::sqrt(2.0) : 0.5 * sampleRate;
+			auto worst = 0.0f;
+			for (int k = (int)std::ceil(low / binWidth); k <= (int)std::floor(high / binWidth); k++)
+				worst = juce::jmax(worst, std::abs(output[(size_t)k] - (float)(1 << layer)));
+			expect(worst == 0.0f, "layer " + juce::String(layer) + " is blended outside its crossovers");
+		}
+	}
+};
+
+static SpectrumCompositeTests spectrumCompositeTests;
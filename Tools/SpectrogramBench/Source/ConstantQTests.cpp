@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    ConstantQTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "ConstantQKernel.h"
+
+//==============================================================================
+// a sine on a band's centre frequency, windowed and transformed like the processor does it, has to
+// read the level of a bin-centred sine in the plain FFT on that band and stay far down an octave away
+class ConstantQKernelTests : public juce::UnitTest
+{
+public:
+	ConstantQKernelTests() : juce::UnitTest("Constant-Q kernel", "Tests") {}
+
+	void runTest() override
+	{
+		for (auto windowTag : { (int)kHanning, (int)kBlackmanHarris })
+		{
+			beginTest("band levels, window " + juce::String(windowTag));
+			checkBandLevels(12, 8192, 8192, windowTag);
+
+			beginTest("band levels, zero padded, window " + juce::String(windowTag));
+			checkBandLevels(24, 16384, 8192, windowTag);
+		}
+
+		beginTest("tables are only rebuilt on a change");
+		ConstantQKernel kernel;
+		expect(kernel.createConstantQKernel(12, sampleRate, 4096, 4096, kHanning));
+		expect(!kernel.createConstantQKernel(12, sampleRate, 4096, 4096, kHanning));
+		expect(kernel.createConstantQKernel(12, sampleRate, 4096, 4096, kBlackman));
+		expectEquals(kernel.getNumBands(), ConstantQKernel::getNumBands(12, sampleRate));
+	}
+
+private:
+	static constexpr double sampleRate = 48000.0;
+	static constexpr double amplitude = 0.5;
+
+	void checkBandLevels(int bandsPerOctave, int fftSize, int windowSize, int windowTag)
+	{
+		ConstantQKernel kernel;
+		kernel.createConstantQKernel(bandsPerOctave, sampleRate, fftSize, windowSize, windowTag);
+
+		// --- a bin-centred sine of this amplitude peaks at amplitude * sum(window) / 2 in the plain FFT
+		auto windowSum = 0.0;
+		for (int n = 0; n < windowSize; n++)
+			windowSum += WindowTable::getWindowValue(windowTag, n, windowSize);
+		auto reference = juce::square(amplitude * windowSum * 0.5);
+
+		juce::dsp::FFT fft(juce::roundToInt(std::log2(fftSize)));
+		std::vector<float> frame((size_t)(2 * fftSize));
+		std::vector<float> power((size_t)kernel.getNumBands());
+
+		// --- from where the kernel fits in the window up to well below nyquist
+		auto worstLevel = 0.0;
+		auto worstRejection = -1000.0;
+		for (int band = 0; band < kernel.getNumBands(); band += 5)
+		{
+			auto frequency = ConstantQKernel::getBandFrequency(band, bandsPerOctave);
+			auto Q = 1.0 / (std::pow(2.0, 1.0 / bandsPerOctave) - 1.0);
+			if (Q * sampleRate / frequency > windowSize || frequency > 0.4 * sampleRate)
+				continue;
+
+			auto phase = getRandom().nextDouble() * juce::MathConstants<double>::twoPi;
+			std::fill(frame.begin(), frame.end(), 0.0f);
+			for (int n = 0; n < windowSize; n++)
+			{
+				auto sine = amplitude * std::cos(juce::MathConstants<double>::twoPi * frequency * n / sampleRate + phase);
+				frame[(size_t)n] = (float)(sine * WindowTable::getWindowValue(windowTag, n, windowSize));
+			}
+			fft.performRealOnlyForwardTransform(frame.data(), true);
+			kernel.apply(reinterpret_cast<const std::complex<float>*>(frame.data()), power.data(), 1.0f);
+
+			auto level = 10.0 * std::log10(power[(size_t)band] / reference);
+			worstLevel = juce::jmax(worstLevel, std::abs(level));
+			for (auto other : { band - bandsPerOctave, band + bandsPerOctave })
+			{
+				if (other >= 0 && other < kernel.getNumBands())
+					worstRejection = juce::jmax(worstRejection, 10.0 * std::log10(juce::jmax((double)power[(size_t)other], 1.0e-30) / reference));
+			}
+		}
+
+		expect(worstLevel < 0.01, "level off by " + juce::String(worstLevel, 3) + " dB");
+		expect(worstRejection < -60.0, "an octave away only " + juce::String(worstRejection, 1) + " dB down");
+	}
+};
+
+static ConstantQKernelTests constantQKernelTests;
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    FifoTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include <thread>
+
+#include "SpectrumFifo.h"
+
+//==============================================================================
+// frames begun ahead of time must still come out in the order they were begun, and every frame
+// the producer wanted has to show up either as a frame, a sequence gap or a skipped read
+class SpectrumFifoTests : public juce::UnitTest
+{
+public:
+	SpectrumFifoTests() : juce::UnitTest("Spectrum fifo", "Tests") {}
+
+	void runTest() override
+	{
+		beginTest("several writes begun before they finish arrive in order");
+		checkBegunWrites();
+
+		beginTest("a full ring and a skipped write leave a sequence gap");
+		checkOverruns();
+
+		beginTest("reading the newest frame counts the ones it skips");
+		checkReadLatest();
+
+		beginTest("producer and consumer threads");
+		checkThreads(false);
+		checkThreads(true);
+	}
+
+private:
+	// --- the producer marks each frame with its own sequence, so a reader can tell a stale slot
+	static void write(SpectrumFrame& frame)
+	{
+		frame.samplePosition = (int64_t)frame.sequence;
+		frame.bins[0] = std::complex<float>((float)frame.sequence, 0.0f);
+	}
+
+	bool isIntact(const SpectrumFrame& frame)
+	{
+		return frame.samplePosition == (int64_t)frame.sequence && frame.bins[0].real() == (float)frame.sequence;
+	}
+
+	void checkBegunWrites()
+	{
+		SpectrumFifo fifo;
+		fifo.createFifo(8, 4);
+
+		// --- three frames in flight, nothing is visible until the oldest is finished
+		SpectrumFrame* frames[3];
+		for (auto& frame : frames)
+		{
+			frame = fifo.beginWrite();
+			expect(frame != nullptr);
+		}
+		expect(fifo.beginRead() == nullptr, "a begun frame is visible");
+
+		// --- filled newest first, finishWrite still publishes the oldest
+		for (int i = 2; i >= 0; i--)
+			write(*frames[i]);
+
+		fifo.finishWrite();
+		expectEquals(fifo.getNumReady(), 1);
+		for (uint64_t sequence = 0; sequence < 3; sequence++)
+		{
+			if (sequence > 0)
+				fifo.finishWrite();
+
+			auto* frame = fifo.beginRead();
+			expect(frame != nullptr && frame->sequence == sequence && isIntact(*frame), "frame " + juce::String((int)sequence));
+			fifo.finishRead();
+		}
+		expect(fifo.beginRead() == nullptr);
+		expectEquals((int)fifo.getOverrunCount(), 0);
+	}
+
+	void checkOverruns()
+	{
+		SpectrumFifo fifo;
+		fifo.createFifo(4, 4);
+
+		// --- begun slots count against the capacity as much as finished ones
+		for (int i = 0; i < 4; i++)
+			write(*fifo.beginWrite());
+		expect(fifo.beginWrite() == nullptr, "a fifth frame fits into four slots");
+		fifo.skipWrite();
+		for (int i = 0; i < 4; i++)
+			fifo.finishWrite();
+		expectEquals((int)fifo.getOverrunCount(), 2);
+
+		for (int i = 0; i < 4; i++)
+		{
+			expectEquals((int)fifo.beginRead()->sequence, i);
+			fifo.finishRead();
+		}
+
+		// --- sequences 4 and 5 never arrive
+		write(*fifo.beginWrite());
+		fifo.finishWrite();
+		expectEquals((int)fifo.beginRead()->sequence, 6);
+		fifo.finishRead();
+	}
+
+	void checkReadLatest()
+	{
+		SpectrumFifo fifo;
+		fifo.createFifo(8, 4);
+		expect(fifo.beginReadLatest() == nullptr);
+
+		for (int i = 0; i < 5; i++)
+		{
+			write(*fifo.beginWrite());
+			fifo.finishWrite();
+		}
+
+		// --- one more begun but not finished, the reader must not see it
+		write(*fifo.beginWrite());
+
+		auto* frame = fifo.beginReadLatest();
+		expect(frame != nullptr && frame->sequence == 4 && isIntact(*frame), "not the newest finished frame");
+		expectEquals((int)fifo.getDroppedCount(), 4);
+		fifo.finishRead();
+		expect(fifo.beginRead() == nullptr);
+
+		// --- a single pending frame is taken without counting a drop
+		fifo.finishWrite();
+		frame = fifo.beginReadLatest();
+		expect(frame != nullptr && frame->sequence == 5);
+		fifo.finishRead();
+		expectEquals((int)fifo.getDroppedCount(), 4);
+
+		// --- the skipped slots are free again, the whole ring can be filled
+		for (int i = 0; i < 8; i++)
+			expect(fifo.beginWrite() != nullptr, "slot " + juce::String(i) + " was not handed back");
+	}
+
+	void checkThreads(bool readLatest)
+	{
+		static constexpr int numFrames = 200000;
+		static constexpr int maxInFlight = 3;
+
+		SpectrumFifo fifo;
+		fifo.createFifo(8, 4);
+
+		// --- keeps up to three frames begun, fills them in any order and finishes the oldest
+		std::thread producer([&fifo]
+		{
+			SpectrumFrame* inFlight[maxInFlight] = {};
+			auto numInFlight = 0;
+			for (int i = 0; i < numFrames; i++)
+			{
+				if (auto* frame = fifo.beginWrite())
+					inFlight[numInFlight++] = frame;
+
+				if (numInFlight == maxInFlight || (numInFlight > 0 && i == numFrames - 1))
+				{
+					for (int j = numInFlight - 1; j >= 0; j--)
+						write(*inFlight[j]);
+					for (int j = 0; j < numInFlight; j++)
+						fifo.finishWrite();
+					numInFlight = 0;
+				}
+			}
+		});
+
+		auto numRead = 0;
+		auto isOrdered = true;
+		auto allIntact = true;
+		int64_t lastSequence = -1;
+		while (lastSequence < numFrames - 1)
+		{
+			auto* frame = readLatest ? fifo.beginReadLatest() : fifo.beginRead();
+			if (frame == nullptr)
+			{
+				if (fifo.getOverrunCount() + fifo.getDroppedCount() + (uint64_t)numRead == numFrames)
+					break;
+				std::this_thread::yield();
+				continue;
+			}
+
+			isOrdered = isOrdered && (int64_t)frame->sequence > lastSequence;
+			allIntact = allIntact && isIntact(*frame);
+			lastSequence = (int64_t)frame->sequence;
+			numRead++;
+			fifo.finishRead();
+		}
+		producer.join();
+
+		auto mode = juce::String(readLatest ? "newest only" : "every frame");
+		expect(isOrdered, mode + ", out of order");
+		expect(allIntact, mode + ", a frame was read while it was written");
+		expectEquals((int)(fifo.getOverrunCount() + fifo.getDroppedCount()) + numRead, numFrames, mode + ", frames unaccounted for");
+		if (!readLatest)
+			expectEquals((int)fifo.getDroppedCount(), 0);
+	}
+};
+
+static SpectrumFifoTests spectrumFifoTests;
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    InterpolationBench.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "CircularBuffer.h"
+
+//==============================================================================
+// block reads of a modulated delay line, one row per interpolator, for a plain ring and a mirrored one;
+// times are per output sample, the last column is the speed up on the linear read of the same ring
+class InterpolationBench : public juce::UnitTest
+{
+public:
+	InterpolationBench() : juce::UnitTest("Fractional delay reads", "Benchmarks") {}
+
+	void runTest() override
+	{
+		beginTest("plain ring, " + juce::String(blockSize) + " samples per block");
+		runAll(false);
+
+		beginTest("mirrored ring, " + juce::String(blockSize) + " samples per block");
+		runAll(true);
+	}
+
+private:
+	static constexpr int ringLength = 65536;
+	static constexpr int blockSize = 512;
+	static constexpr int numCalls = 2000;
+
+	void runAll(bool mirrored)
+	{
+		CircularBuffer<float> ring;
+		ring.createCircularBuffer(ringLength, mirrored);
+		std::vector<float> input(blockSize);
+		for (auto& sample : input)
+			sample = getRandom().nextFloat() * 2.0f - 1.0f;
+		for (int i = 0; i < ringLength / blockSize; i++)
+			ring.writeBuffer(input.data(), blockSize);
+
+		// --- a sweep of 10 to 20 ms at 48 kHz, far enough in that the widest lagrange stays inside the ring
+		delays.resize(blockSize);
+		for (int i = 0; i < blockSize; i++)
+			delays[(size_t)i] = 480.0f + 240.0f * (1.0f + std::sin(juce::MathConstants<float>::twoPi * (float)i / (float)blockSize));
+		output.resize(blockSize);
+
+		auto reference = run<CircularBuffer<float>::kInterpolateLinear>(ring, "linear", 0.0);
+		run<CircularBuffer<float>::kInterpolateHermite>(ring, "hermite", reference);
+		run<CircularBuffer<float>::kInterpolateLagrange, 3>(ring, "lagrange 3", reference);
+		run<CircularBuffer<float>::kInterpolateLagrange, 5>(ring, "lagrange 5", reference);
+		run<CircularBuffer<float>::kInterpolateLagrange, 7>(ring, "lagrange 7", reference);
+		run<CircularBuffer<float>::kInterpolateAllpass>(ring, "allpass", reference);
+	}
+
+	template <int Interpolation, int Order = 3>
+	double run(CircularBuffer<float>& ring, const juce::String& name, double reference)
+	{
+		auto nanoseconds = measureNanoseconds([&]
+		{
+			ring.readBuffer<Interpolation, Order>(output.data(), delays.data(), blockSize);
+		}, numCalls) / blockSize;
+
+		logMessage(formatBenchRow(name, nanoseconds, reference > 0.0 ? reference : nanoseconds));
+		// --- keeps the reads from being optimised away
+		expect(std::isfinite(output[blockSize / 2]));
+		return nanoseconds;
+	}
+
+	std::vector<float> delays;
+	std::vector<float> output;
+};
+
+static InterpolationBench interpolationBench;
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    KernelBench.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "KernelVariants.h"
+
+//==============================================================================
+// each kernel on every instruction set path over the bins of an 8192 point transform,
+// the last column is the speed up on the scalar path
+class SpectrumKernelsBench : public juce::UnitTest
+{
+public:
+	SpectrumKernelsBench() : juce::UnitTest("Spectrum kernels", "Benchmarks") {}
+
+	void runTest() override
+	{
+		std::vector<std::complex<float>> bins(numValues);
+		std::vector<float> power(numValues);
+		std::vector<float> state(numValues);
+		std::vector<float> output(numValues);
+		for (int i = 0; i < numValues; i++)
+		{
+			bins[(size_t)i] = { getRandom().nextFloat() - 0.5f, getRandom().nextFloat() - 0.5f };
+			power[(size_t)i] = getRandom().nextFloat() + 1.0e-6f;
+			state[(size_t)i] = getRandom().nextFloat();
+		}
+
+		auto variants = getBuiltKernelVariants();
+		beginTest("squaredMagnitude, " + juce::String(numValues) + " bins");
+		run(variants, [&](const KernelVariant& variant)
+		{
+			variant.squaredMagnitude(bins.data(), output.data(), numValues, 0.5f);
+		});
+
+		beginTest("powerToDecibels, " + juce::String(numValues) + " values");
+		run(variants, [&](const KernelVariant& variant)
+		{
+			variant.powerToDecibels(power.data(), output.data(), numValues, 6.0f, 1.0e-20f);
+		});
+
+		beginTest("smooth, " + juce::String(numValues) + " values");
+		run(variants, [&](const KernelVariant& variant)
+		{
+			variant.smooth(state.data(), power.data(), numValues, 0.5f, 0.1f);
+		});
+
+		beginTest("complexDot, " + juce::String(numValues) + " bins");
+		std::complex<float> sum;
+		run(variants, [&](const KernelVariant& variant)
+		{
+			sum += variant.complexDot(bins.data(), bins.data(), numValues);
+		});
+		// --- keeps the dot products from being optimised away
+		expect(std::isfinite(sum.real()));
+	}
+
+private:
+	static constexpr int numValues = 4097;
+	static constexpr int numCalls = 2000;
+
+	template <typename Kernel>
+	void run(const std::vector<KernelVariant>& variants, Kernel&& kernel)
+	{
+		auto reference = 0.0;
+		for (auto& variant : variants)
+		{
+			if (variant.needsAVX2 && !juce::SystemStats::hasAVX2())
+				continue;
+
+			auto nanoseconds = measureNanoseconds([&] { kernel(variant); }, numCalls);
+			if (reference == 0.0)
+				reference = nanoseconds;
+			logMessage(formatBenchRow(variant.name, nanoseconds, reference));
+		}
+	}
+};
+
+static SpectrumKernelsBench spectrumKernelsBench;
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    KernelTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "KernelVariants.h"
+
+//==============================================================================
+// every instruction set path against double precision maths, at every length up to a few vectors
+// so each tail shows up, and one float past an aligned start so no load may assume alignment
+class SpectrumKernelsTests : public juce::UnitTest
+{
+public:
+	SpectrumKernelsTests() : juce::UnitTest("Spectrum kernels", "Tests") {}
+
+	void runTest() override
+	{
+		for (auto& variant : getBuiltKernelVariants())
+		{
+			if (variant.needsAVX2 && !juce::SystemStats::hasAVX2())
+			{
+				logMessage(juce::String(variant.name) + " skipped, the CPU does not have it");
+				continue;
+			}
+
+			beginTest(juce::String("squaredMagnitude ") + variant.name);
+			for (auto length : getLengths())
+				checkSquaredMagnitude(variant, length);
+
+			beginTest(juce::String("powerToDecibels ") + variant.name);
+			for (auto length : getLengths())
+				checkPowerToDecibels(variant, length);
+
+			beginTest(juce::String("smooth ") + variant.name);
+			for (auto length : getLengths())
+				checkSmooth(variant, length);
+
+			beginTest(juce::String("complexDot ") + variant.name);
+			for (auto length : getLengths())
+				checkComplexDot(variant, length);
+		}
+	}
+
+private:
+	static juce::Array<int> getLengths()
+	{
+		// --- 0 to 40 covers every tail of 4 and 8 lane vectors, the rest are frame sized
+		juce::Array<int> lengths;
+		for (int length = 0; length <= 40; length++)
+			lengths.add(length);
+		lengths.addArray({ 129, 1023, 1025, 4097 });
+		return lengths;
+	}
+
+	float nextValue(float range)
+	{
+		return (getRandom().nextFloat() * 2.0f - 1.0f) * range;
+	}
+
+	//==============================================================================
+	void checkSquaredMagnitude(const KernelVariant& variant, int length)
+	{
+		std::vector<std::complex<float>> bins((size_t)length + 1);
+		std::vector<float> power((size_t)length + 2, -1.0f);
+		for (auto& bin : bins)
+			bin = { nextValue(100.0f), nextValue(100.0f) };
+
+		auto scale = 0.25f;
+		variant.squaredMagnitude(bins.data() + 1, power.data() + 1, length, scale);
+
+		auto worst = 0.0;
+		for (int i = 0; i < length; i++)
+		{
+			auto re = (double)bins[(size_t)i + 1].real();
+			auto im = (double)bins[(size_t)i + 1].imag();
+			auto expected = (double)scale * (re * re + im * im);
+			worst = juce::jmax(worst, std::abs((double)power[(size_t)i + 1] - expected) / juce::jmax(expected, 1.0e-30));
+		}
+		expect(worst < 1.0e-6, "length " + juce::String(length) + ", relative error " + juce::String(worst));
+		expect(power.front() == -1.0f && power.back() == -1.0f, "length " + juce::String(length) + " wrote outside the output");
+	}
+
+	void checkPowerToDecibels(const KernelVariant& variant, int length)
+	{
+		std::vector<float> power((size_t)length + 1);
+		std::vector<float> decibels((size_t)length + 2, 1000.0f);
+		// --- -120 to +20 dB where the documented bound holds, with exact zeros for the floor
+		for (auto& value : power)
+			value = getRandom().nextInt(16) == 0 ? 0.0f : std::pow(10.0f, getRandom().nextFloat() * 14.0f - 12.0f);
+
+		auto offsetdB = 6.0f;
+		auto minPower = 1.0e-12f;
+		variant.powerToDecibels(power.data() + 1, decibels.data() + 1, length, offsetdB, minPower);
+
+		auto worst = 0.0;
+		for (int i = 0; i < length; i++)
+		{
+			auto expected = 10.0 * std::log10(juce::jmax((double)power[(size_t)i + 1], (double)minPower)) - offsetdB;
+			worst = juce::jmax(worst, std::abs((double)decibels[(size_t)i + 1] - expected));
+		}
+		expect(worst < 2.0e-5, "length " + juce::String(length) + ", error " + juce::String(worst) + " dB");
+		expect(decibels.front() == 1000.0f && decibels.back() == 1000.0f, "length " + juce::String(length) + " wrote outside the output");
+	}
+
+	void checkSmooth(const KernelVariant& variant, int length)
+	{
+		std::vector<float> state((size_t)length + 2, -1.0f);
+		std::vector<float> input((size_t)length + 1);
+		for (int i = 0; i < length; i++)
+		{
+			state[(size_t)i + 1] = nextValue(1.0f);
+			input[(size_t)i + 1] = nextValue(1.0f);
+		}
+		auto expected = state;
+
+		auto attack = 0.75f;
+		auto release = 0.125f;
+		variant.smooth(state.data() + 1, input.data() + 1, length, attack, release);
+
+		auto worst = 0.0;
+		for (int i = 1; i <= length; i++)
+		{
+			auto s = (double)expected[(size_t)i];
+			auto x = (double)input[(size_t)i];
+			auto coefficient = x > s ? attack : release;
+			worst = juce::jmax(worst, std::abs((double)state[(size_t)i] - (s + coefficient * (x - s))));
+		}
+		expect(worst < 1.0e-6, "length " + juce::String(length) + ", error " + juce::String(worst));
+		expect(state.front() == -1.0f && state.back() == -1.0f, "length " + juce::String(length) + " wrote outside the state");
+	}
+
+	void checkComplexDot(const KernelVariant& variant, int length)
+	{
+		std::vector<std::complex<float>> a((size_t)length + 1);
+		std::vector<std::complex<float>> b((size_t)length + 1);
+		for (int i = 0; i <= length; i++)
+		{
+			a[(size_t)i] = { nextValue(1.0f), nextValue(1.0f) };
+			b[(size_t)i] = { nextValue(1.0f), nextValue(1.0f) };
+		}
+
+		auto result = variant.complexDot(a.data() + 1, b.data() + 1, length);
+
+		// --- float sums in any order stay within the textbook bound, n + 2 roundings of the sum of the magnitudes
+		std::complex<double> expected;
+		auto magnitude = 0.0;
+		for (int i = 1; i <= length; i++)
+		{
+			expected += std::complex<double>(a[(size_t)i]) * std::complex<double>(b[(size_t)i]);
+			magnitude += std::abs(std::complex<double>(a[(size_t)i])) * std::abs(std::complex<double>(b[(size_t)i]));
+		}
+		auto error = std::abs(std::complex<double>(result) - expected);
+		expect(error <= (length + 2) * 1.2e-7 * magnitude, "length " + juce::String(length) + ", error " + juce::String(error));
+	}
+};
+
+static SpectrumKernelsTests spectrumKernelsTests;
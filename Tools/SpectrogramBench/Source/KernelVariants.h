@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    KernelVariants.h
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <complex>
+#include <vector>
+
+//==============================================================================
+/**
+	One build of SpectrumKernels.h per instruction set, side by side in the
+	same binary so every path can be checked and timed on one machine.
+
+	Each variant comes from a file of its own compiled for that instruction
+	set, in a namespace of its own. The function pointers are null when this
+	compiler or target cannot build the instruction set (NEON on x86, AVX2
+	under MSVC without /arch:AVX2), needsAVX2 asks the caller to check the
+	CPU before running it.
+*/
+struct KernelVariant
+{
+	const char* name;
+	bool needsAVX2;
+	void (*squaredMagnitude)(const std::complex<float>* bins, float* power, int numBins, float scale);
+	void (*powerToDecibels)(const float* power, float* decibels, int numValues, float offsetdB, float minPower);
+	void (*smooth)(float* state, const float* input, int numValues, float attack, float release);
+	std::complex<float> (*complexDot)(const std::complex<float>* a, const std::complex<float>* b, int n);
+
+	bool isBuilt() const { return squaredMagnitude != nullptr; }
+};
+
+#define SPECTRUM_KERNEL_VARIANT(name, needsAVX2, kernels) \
+	KernelVariant { name, needsAVX2, kernels::squaredMagnitude, kernels::powerToDecibels, kernels::smooth, kernels::complexDot }
+
+KernelVariant getScalarKernels();
+KernelVariant getSSE2Kernels();
+KernelVariant getAVX2Kernels();
+KernelVariant getNEONKernels();
+
+// the variants this build has, scalar first
+inline std::vector<KernelVariant> getBuiltKernelVariants()
+{
+	std::vector<KernelVariant> variants;
+	for (auto& variant : { getScalarKernels(), getSSE2Kernels(), getAVX2Kernels(), getNEONKernels() })
+	{
+		if (variant.isBuilt())
+			variants.push_back(variant);
+	}
+	return variants;
+}
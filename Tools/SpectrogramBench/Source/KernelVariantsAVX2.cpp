@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    KernelVariantsAVX2.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+// --- compiled with the avx2 flag scheme of the project. Nothing here may include JUCE: its inline
+//     functions would be built for AVX2 as well and the linker is free to keep those copies
+#define SPECTRUM_KERNELS_NAMESPACE SpectrumKernelsAVX2
+#include "SpectrumKernels.h"
+#include "KernelVariants.h"
+
+#if SPECTRUM_KERNELS_AVX2
+KernelVariant getAVX2Kernels()
+{
+	return SPECTRUM_KERNEL_VARIANT("AVX2", true, SpectrumKernelsAVX2);
+}
+#else
+KernelVariant getAVX2Kernels()
+{
+	return { "AVX2", true };
+}
+#endif
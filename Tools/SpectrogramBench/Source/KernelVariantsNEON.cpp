@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    KernelVariantsNEON.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#define SPECTRUM_KERNELS_NAMESPACE SpectrumKernelsNEON
+#include "SpectrumKernels.h"
+#include "KernelVariants.h"
+
+#if SPECTRUM_KERNELS_NEON
+KernelVariant getNEONKernels()
+{
+	return SPECTRUM_KERNEL_VARIANT("NEON", false, SpectrumKernelsNEON);
+}
+#else
+KernelVariant getNEONKernels()
+{
+	return { "NEON", false };
+}
+#endif
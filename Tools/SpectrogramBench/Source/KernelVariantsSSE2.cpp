@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    KernelVariantsSSE2.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+// --- capped at SSE2 even when the project itself targets AVX2
+#define SPECTRUM_KERNELS_NO_AVX2 1
+#define SPECTRUM_KERNELS_NAMESPACE SpectrumKernelsSSE2
+#include "SpectrumKernels.h"
+#include "KernelVariants.h"
+
+#if SPECTRUM_KERNELS_SSE2
+KernelVariant getSSE2Kernels()
+{
+	return SPECTRUM_KERNEL_VARIANT("SSE2", false, SpectrumKernelsSSE2);
+}
+#else
+KernelVariant getSSE2Kernels()
+{
+	return { "SSE2", false };
+}
+#endif
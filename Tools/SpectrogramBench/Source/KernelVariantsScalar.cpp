@@ -0,0 +1,20 @@
+/*
+  ==============================================================================
+
+    KernelVariantsScalar.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+// --- the fallback every other path is checked against, also what runs a tail too short for a vector
+#define SPECTRUM_KERNELS_SCALAR 1
+#define SPECTRUM_KERNELS_NAMESPACE SpectrumKernelsScalar
+#include "SpectrumKernels.h"
+#include "KernelVariants.h"
+
+KernelVariant getScalarKernels()
+{
+	return SPECTRUM_KERNEL_VARIANT("scalar", false, SpectrumKernelsScalar);
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// checks and timings of the analysis code outside the plugin, build it in Release for timings
+// that mean anything; the exit code is the number of failed checks
+static const char* const usage =
+	"SpectrogramBench [options]\n"
+	"\n"
+	"  --tests           run the checks only\n"
+	"  --bench           run the benchmarks only\n"
+	"  --seed=<n>        random seed of the checks (0 picks one)\n";
+
+int main (int argc, char* argv[])
+{
+	juce::ArgumentList args(argc, argv);
+	if (args.containsOption("--help|-h"))
+	{
+		std::cout << usage;
+		return 0;
+	}
+
+	auto runTests = !args.containsOption("--bench") || args.containsOption("--tests");
+	auto runBench = !args.containsOption("--tests") || args.containsOption("--bench");
+	auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue() : 0;
+
+	juce::UnitTestRunner runner;
+	runner.setAssertOnFailure(false);
+	if (runTests)
+		runner.runTestsInCategory("Tests", seed);
+
+	auto numFailures = 0;
+	for (int i = 0; i < runner.getNumResults(); i++)
+		numFailures += runner.getResult(i)->failures;
+
+	if (runBench)
+		runner.runTestsInCategory("Benchmarks", seed);
+
+	return numFailures;
+}
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    SlicedFFTTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "SlicedFFT.h"
+
+//==============================================================================
+// the slices of a large frame, run pass by pass in any order inside a pass, have to give the
+// bins the plain real transform gives for the same windowed samples
+class SlicedFFTTests : public juce::UnitTest
+{
+public:
+	SlicedFFTTests() : juce::UnitTest("Sliced FFT", "Tests") {}
+
+	void runTest() override
+	{
+		for (auto order : { 15, 16 })
+		{
+			beginTest("order " + juce::String(order) + " against a direct FFT");
+			checkAgainstDirect(order, 0, false);
+
+			beginTest("order " + juce::String(order) + ", window wrapped around the ring");
+			checkAgainstDirect(order, 0, true);
+
+			beginTest("order " + juce::String(order) + ", zero padded");
+			checkAgainstDirect(order, 1, true);
+		}
+	}
+
+private:
+	static constexpr size_t alignment = 64;
+
+	struct AlignedStorage
+	{
+		explicit AlignedStorage(size_t numBytes)
+			: storage(new char[numBytes + alignment]())
+		{
+			auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+			data = reinterpret_cast<void*>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+		}
+
+		std::unique_ptr<char[]> storage;
+		void* data = nullptr;
+	};
+
+	void checkAgainstDirect(int order, int paddingOrder, bool isWrapped)
+	{
+		auto fftSize = 1 << order;
+		auto windowSize = fftSize >> paddingOrder;
+
+		// --- a random window over random samples, split into two spans like a window across the end of a ring
+		auto& random = getRandom();
+		std::vector<float> samples((size_t)windowSize), window((size_t)windowSize);
+		for (int n = 0; n < windowSize; n++)
+		{
+			samples[(size_t)n] = random.nextFloat() * 2.0f - 1.0f;
+			window[(size_t)n] = random.nextFloat() * 0.5f + 0.5f;
+		}
+		auto size1 = isWrapped ? windowSize / 3 * 2 + 1 : windowSize;
+		CircularBuffer<float>::Spans spans { samples.data(), size1, samples.data() + size1, windowSize - size1 };
+
+		juce::dsp::FFT direct(order);
+		std::vector<float> expected((size_t)(2 * fftSize), 0.0f);
+		for (int n = 0; n < windowSize; n++)
+			expected[(size_t)n] = samples[(size_t)n] * window[(size_t)n];
+		direct.performRealOnlyForwardTransform(expected.data(), true);
+
+		FFTPlanCache plans;
+		SlicedFFT sliced;
+		sliced.createSlicedFFT(order, 4096, plans);
+		expect(sliced.getNumSlices() > 1, "order " + juce::String(order) + " is not sliced");
+
+		AlignedStorage binStorage((size_t)(fftSize / 2 + 1) * sizeof(std::complex<float>));
+		AlignedStorage scratchStorage((size_t)sliced.getScratchSize() * sizeof(std::complex<float>));
+		auto* bins = static_cast<std::complex<float>*>(binStorage.data);
+		auto* scratch = static_cast<std::complex<float>*>(scratchStorage.data);
+
+		// --- backwards inside every pass, the pool makes no promise about the order of the slices
+		for (int slice = sliced.getNumSlices() - 1; slice >= 0; slice--)
+			sliced.performRows(slice, spans, window.data(), windowSize, bins, scratch);
+		for (int slice = sliced.getNumSlices() - 1; slice >= 0; slice--)
+			sliced.performColumns(slice, bins, scratch);
+		for (int slice = sliced.getNumSlices() - 1; slice >= 0; slice--)
+			sliced.performSplit(slice, bins);
+
+		auto worst = 0.0;
+		auto largest = 0.0;
+		for (int k = 0; k <= fftSize / 2; k++)
+		{
+			std::complex<double> reference(expected[(size_t)(2 * k)], expected[(size_t)(2 * k + 1)]);
+			worst = juce::jmax(worst, std::abs(std::complex<double>(bins[k]) - reference));
+			largest = juce::jmax(largest, std::abs(reference));
+		}
+		expect(worst < 1.0e-5 * largest, "relative error " + juce::String(worst / largest));
+	}
+};
+
+static SlicedFFTTests slicedFFTTests;
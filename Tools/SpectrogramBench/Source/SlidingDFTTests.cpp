@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    SlidingDFTTests.cpp
+    Created: 18 Oct 2026
+    Author:  kweiwen tseng
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "SlidingDFT.h"
+
+//==============================================================================
+// after any number of samples fed in blocks of any length, the band has to read what a
+// Hann-windowed DFT of the last N samples gives, and its rounding must not build up
+class SlidingDFTTests : public juce::UnitTest
+{
+public:
+	SlidingDFTTests() : juce::UnitTest("Sliding DFT", "Tests") {}
+
+	void runTest() override
+	{
+		beginTest("power against a windowed direct DFT");
+		checkAgainstDirect(8, 0, 10);
+		checkAgainstDirect(8, 5, 10);
+		checkAgainstDirect(8, 120, 10);
+		checkAgainstDirect(10, 40, 64);
+
+		beginTest("a bin-centred sine reads its level");
+		checkSineLevel();
+
+		beginTest("nothing is left after the input goes silent");
+		checkDrift();
+	}
+
+private:
+	static constexpr int numChannels = 2;
+
+	// --- 4 |X|^2 of the periodic Hann window over samples[end - N .. end - 1], averaged over the channels
+	static double getDirectPower(const std::vector<float>* samples, int end, int size, int bin)
+	{
+		auto power = 0.0;
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			std::complex<double> sum;
+			for (int n = 0; n < size; n++)
+			{
+				auto phase = juce::MathConstants<double>::twoPi * n / size;
+				auto window = 0.5 - 0.5 * std::cos(phase);
+				sum += (double)samples[channel][(size_t)(end - size + n)] * window * std::polar(1.0, -phase * bin);
+			}
+			power += 4.0 * std::norm(sum);
+		}
+		return power / numChannels;
+	}
+
+	void checkAgainstDirect(int order, int firstBin, int numBins)
+	{
+		auto size = 1 << order;
+		auto numSamples = 12 * size;
+
+		// --- noise on one channel and a sine between bins on the other, silence before the first sample
+		auto& random = getRandom();
+		std::vector<float> samples[numChannels];
+		for (auto& channel : samples)
+			channel.assign((size_t)(size + numSamples), 0.0f);
+		for (int n = size; n < size + numSamples; n++)
+		{
+			samples[0][(size_t)n] = random.nextFloat() * 2.0f - 1.0f;
+			samples[1][(size_t)n] = 0.3f * std::sin(0.37f * (float)n);
+		}
+
+		SlidingDFT sliding;
+		sliding.createSlidingDFT(numChannels, order, firstBin, numBins);
+		std::vector<float> power((size_t)sliding.getNumBins());
+
+		// --- uneven blocks, so the reads land anywhere inside the window and during the fill
+		auto worst = 0.0;
+		auto position = size;
+		while (position < size + numSamples)
+		{
+			auto blockSize = juce::jmin(1 + random.nextInt(3 * size / 4), size + numSamples - position);
+			const float* input[numChannels];
+			const float* delayed[numChannels];
+			for (int channel = 0; channel < numChannels; channel++)
+			{
+				input[channel] = samples[channel].data() + position;
+				delayed[channel] = samples[channel].data() + position - size;
+			}
+			sliding.process(input, delayed, numChannels, blockSize);
+			position += blockSize;
+
+			// --- relative to the bin, or to the noise floor for the bins the window's zeros fall on
+			sliding.getPower(power.data(), numChannels);
+			auto floor = 1.0e-3 * size;
+			for (int i = 0; i < sliding.getNumBins(); i++)
+			{
+				auto expected = getDirectPower(samples, position, size, sliding.getFirstBin() + i);
+				worst = juce::jmax(worst, std::abs(power[(size_t)i] - expected) / (expected + floor));
+			}
+		}
+		expect(worst < 1.0e-3, "bins from " + juce::String(firstBin) + ", relative error " + juce::String(worst));
+	}
+
+	void checkSineLevel()
+	{
+		// --- full scale on bin 100, 0 dB once the coherent gain is taken out
+		auto size = 1 << 10;
+		std::vector<float> samples((size_t)(3 * size), 0.0f);
+		for (int n = size; n < 3 * size; n++)
+			samples[(size_t)n] = (float)std::sin(juce::MathConstants<double>::twoPi * 100 * n / size);
+
+		SlidingDFT sliding;
+		sliding.createSlidingDFT(1, 10, 0, size / 2 + 1);
+		const float* input[] = { samples.data() + size };
+		const float* delayed[] = { samples.data() };
+		sliding.process(input, delayed, 1, 2 * size);
+
+		std::vector<float> power((size_t)sliding.getNumBins());
+		sliding.getPower(power.data(), 1);
+		auto level = 10.0 * std::log10(power[100]) - 20.0 * std::log10(size * SlidingDFT::coherentGain);
+		expect(std::abs(level) < 0.01, "level off by " + juce::String(level, 3) + " dB");
+	}
+
+	void checkDrift()
+	{
+		// --- a few million samples of noise, then a whole window of silence
+		auto size = 1 << 10;
+		auto numNoise = 4000000;
+		auto numSamples = numNoise + 2 * size;
+		std::vector<float> samples((size_t)(size + numSamples), 0.0f);
+		auto& random = getRandom();
+		for (int n = size; n < size + numNoise; n++)
+			samples[(size_t)n] = random.nextFloat() * 2.0f - 1.0f;
+
+		SlidingDFT sliding;
+		sliding.createSlidingDFT(1, 10, 0, size / 2 + 1);
+		for (int position = size; position < size + numSamples; position += 64)
+		{
+			const float* input[] = { samples.data() + position };
+			const float* delayed[] = { samples.data() + position - size };
+			sliding.process(input, delayed, 1, juce::jmin(64, size + numSamples - position));
+		}
+
+		std::vector<float> power((size_t)sliding.getNumBins());
+		sliding.getPower(power.data(), 1);
+		auto largest = *std::max_element(power.begin(), power.end());
+		expect(largest == 0.0f, "power " + juce::String(largest) + " left over");
+	}
+};
+
+static SlidingDFTTests slidingDFTTests;
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "OfflineAnalysis.h"
+#include "SpectrumKernels.h"
+
+//==============================================================================
+// headless batch analysis, every input file gets a .spectrogram file with one row per frame
+//
+// file layout, little-endian:
+//   "SPGM", int32 version, float64 sample rate, int32 fft size, int32 window size,
+//   int32 hop size, int32 bins per frame, int32 window tag, int32 channels, int64 frames
+//   then per frame: int64 input samples up to the end of the frame, bins float32 in dB re
+//   a full scale sine, the mean power of all channels like the plugin's "All" source
+static const int fileVersion = 1;
+static const char* const fileExtension = ".spectrogram";
+static const char* const inputPattern = "*.wav;*.flac;*.aif;*.aiff";
+// samples read from the file per block
+static const int readBlockSize = 65536;
+
+static const char* const usage =
+	"SpectrogramCLI [options] <file or folder>...\n"
+	"\n"
+	"  --size=<n>        window size, a power of 2 from 256 to 65536 (2048)\n"
+	"  --padding=<n>     zero padding, 0 = none, 1 = 2x, 2 = 4x, 3 = 8x (0)\n"
+	"  --window=<name>   rectangular, hanning, hamming, blackman, triangle, kaiser,\n"
+	"                    flattop, blackman-harris or gaussian (hanning)\n"
+	"  --overlap=<n>     1 = 0%, 2 = 50%, 3 = 75%, 4 = 87.5% (3)\n"
+	"  --output=<dir>    where the results go, next to each input by default,\n"
+	"                    files found in a folder keep their path below it\n"
+	"  --jobs=<n>        files analysed at once (one per core)\n"
+	"  --threads=<n>     transform threads per file (cores / jobs)\n"
+	"  --overwrite       analyse again when the result already exists\n";
+
+struct BatchInput
+{
+	juce::File file;
+	juce::File output;
+};
+
+//==============================================================================
+static int parseWindow(const juce::String& name)
+{
+	// same order as the window function combo box in the editor
+	const char* const names[] = { "rectangular", "hanning", "hamming", "blackman", "triangle",
+		"kaiser", "flattop", "blackman-harris", "gaussian" };
+	for (int tag = kRectangular; tag <= kNumWindowTypes; tag++)
+	{
+		if (name.equalsIgnoreCase(names[tag - 1]))
+			return tag;
+	}
+	return 0;
+}
+
+static int parseOrder(const juce::String& size)
+{
+	auto value = size.getIntValue();
+	if (!juce::isPowerOfTwo(value))
+		return 0;
+
+	auto order = 0;
+	while ((1 << order) < value)
+		order++;
+	return order;
+}
+
+static juce::File getOutputFile(const juce::File& input, const juce::File& root, const juce::File& outputFolder)
+{
+	auto name = input.getFileNameWithoutExtension() + fileExtension;
+	if (outputFolder == juce::File())
+		return input.getSiblingFile(name);
+
+	// inputs found in a folder keep their place below the output folder, so equal names do not collide
+	auto relative = root.isDirectory() ? input.getParentDirectory().getRelativePathFrom(root) : juce::String();
+	return outputFolder.getChildFile(relative).getChildFile(name);
+}
+
+//==============================================================================
+// empty when the file was written, otherwise what went wrong
+static juce::String analyseFile(const BatchInput& input, const OfflineAnalysis::Settings& settings, FFTPlanCache& plans)
+{
+	juce::AudioFormatManager formats;
+	formats.registerBasicFormats();
+	std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input.file));
+	if (reader == nullptr)
+		return "not a readable audio file";
+
+	if (!input.output.getParentDirectory().createDirectory())
+		return "cannot create " + input.output.getParentDirectory().getFullPathName();
+
+	// written next to the result and moved over it at the end, an interrupted run leaves no half file
+	juce::TemporaryFile temporary(input.output);
+	auto stream = temporary.getFile().createOutputStream();
+	if (stream == nullptr || stream->failedToOpen())
+		return "cannot write " + input.output.getFullPathName();
+
+	auto numChannels = juce::jlimit(1, OfflineAnalysis::maxNumChannels, (int)reader->numChannels);
+	std::vector<float> power;
+	std::vector<float> channelPower;
+
+	OfflineAnalysis analysis(plans);
+	analysis.prepare(settings, numChannels, [&](const SpectrumFrame& frame)
+	{
+		// power of the doubled magnitude averaged over the channels, then dB re a full scale sine
+		auto scale = 4.0f / (float)frame.numSources;
+		SpectrumKernels::squaredMagnitude(frame.bins.get(), power.data(), frame.numBins, scale);
+		for (int source = 1; source < frame.numSources; source++)
+		{
+			SpectrumKernels::squaredMagnitude(frame.bins.get() + source * frame.numBins, channelPower.data(), frame.numBins, scale);
+			juce::FloatVectorOperations::add(power.data(), channelPower.data(), frame.numBins);
+		}
+		auto V0 = juce::Decibels::gainToDecibels((float)frame.windowSize * frame.coherentGain);
+		SpectrumKernels::powerToDecibels(power.data(), power.data(), frame.numBins, V0, 1.0e-20f);
+
+		stream->writeInt64(frame.samplePosition);
+		stream->write(power.data(), sizeof(float) * (size_t)frame.numBins);
+	});
+
+	auto& setup = analysis.getSetup();
+	power.resize(setup.numBins);
+	channelPower.resize(setup.numBins);
+
+	stream->write("SPGM", 4);
+	stream->writeInt(fileVersion);
+	stream->writeDouble(reader->sampleRate);
+	stream->writeInt(setup.fftSize);
+	stream->writeInt(setup.windowSize);
+	stream->writeInt(analysis.getHopSize());
+	stream->writeInt(setup.numBins);
+	stream->writeInt(settings.windowTag);
+	stream->writeInt(numChannels);
+	auto framesPosition = stream->getPosition();
+	stream->writeInt64(0);
+
+	// streamed a block at a time, the length of the file never matters
+	juce::AudioBuffer<float> buffer(numChannels, readBlockSize);
+	for (juce::int64 position = 0; position < reader->lengthInSamples;)
+	{
+		auto numSamples = (int)juce::jmin((juce::int64)readBlockSize, reader->lengthInSamples - position);
+		reader->read(&buffer, 0, numSamples, position, true, true);
+		analysis.process(buffer, numSamples);
+		position += numSamples;
+	}
+	analysis.finish();
+
+	stream->setPosition(framesPosition);
+	stream->writeInt64(analysis.getNumFrames());
+	stream->flush();
+	if (stream->getStatus().failed())
+		return stream->getStatus().getErrorMessage();
+
+	stream.reset();
+	if (!temporary.overwriteTargetFileWithTemporary())
+		return "cannot replace " + input.output.getFullPathName();
+
+	return {};
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+	juce::ArgumentList args(argc, argv);
+	if (args.size() == 0 || args.containsOption("--help|-h"))
+	{
+		std::cout << usage;
+		return 0;
+	}
+
+	OfflineAnalysis::Settings settings;
+	settings.fftOrder = parseOrder(args.containsOption("--size") ? args.getValueForOption("--size") : "2048");
+	settings.paddingOrder = args.containsOption("--padding") ? args.getValueForOption("--padding").getIntValue() : 0;
+	settings.windowTag = parseWindow(args.containsOption("--window") ? args.getValueForOption("--window") : "hanning");
+	settings.overlapTag = args.containsOption("--overlap") ? args.getValueForOption("--overlap").getIntValue() : 3;
+
+	// the same limits as the plugin
+	if (settings.fftOrder < 8 || settings.fftOrder > 16 || settings.paddingOrder < 0 || settings.paddingOrder > 3
+		|| settings.fftOrder + settings.paddingOrder > 16 || settings.windowTag == 0
+		|| settings.overlapTag < 1 || settings.overlapTag > 4)
+	{
+		std::cerr << "invalid analysis settings\n\n" << usage;
+		return 1;
+	}
+
+	juce::File outputFolder;
+	if (args.containsOption("--output"))
+		outputFolder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+	auto overwrite = args.containsOption("--overwrite");
+
+	// folders are searched recursively, existing results are skipped so an interrupted batch resumes
+	juce::Array<BatchInput> inputs;
+	auto numSkipped = 0;
+	for (auto& argument : args.arguments)
+	{
+		if (argument.isOption())
+			continue;
+
+		auto root = argument.resolveAsFile();
+		auto files = root.isDirectory() ? root.findChildFiles(juce::File::findFiles, true, inputPattern)
+			: juce::Array<juce::File> { root };
+		files.sort();
+		for (auto& file : files)
+		{
+			auto output = getOutputFile(file, root, outputFolder);
+			if (!overwrite && output.existsAsFile())
+				numSkipped++;
+			else
+				inputs.add({ file, output });
+		}
+	}
+
+	if (inputs.isEmpty())
+	{
+		std::cout << "nothing to analyse, " << numSkipped << " already done\n";
+		return 0;
+	}
+
+	// many files: one per core, each with its own pool; a single file: every core on its frames
+	auto numCpus = juce::SystemStats::getNumCpus();
+	auto numJobs = juce::jlimit(1, inputs.size(), args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue() : numCpus);
+	settings.numThreads = juce::jmax(1, args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue() : numCpus / numJobs);
+
+	// benchmarked once here instead of by every job at the same time
+	FFTPlanCache plans;
+	plans.getPlan(settings.fftOrder + settings.paddingOrder);
+
+	juce::CriticalSection printLock;
+	std::atomic<int> numDone { 0 };
+	std::atomic<int> numFailed { 0 };
+	auto startTicks = juce::Time::getHighResolutionTicks();
+
+	juce::ThreadPool pool(numJobs);
+	for (auto& input : inputs)
+	{
+		pool.addJob([&, input]
+		{
+			auto error = analyseFile(input, settings, plans);
+			auto done = ++numDone;
+			if (error.isNotEmpty())
+				numFailed++;
+
+			const juce::ScopedLock sl(printLock);
+			std::cout << "[" << done << "/" << inputs.size() << "] " << input.file.getFullPathName()
+				<< (error.isEmpty() ? "" : ": " + error) << std::endl;
+		});
+	}
+
+	while (pool.getNumJobs() > 0)
+	{
+		juce::Thread::sleep(100);
+	}
+
+	auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+	std::cout << numDone.load() - numFailed.load() << " analysed, " << numFailed.load() << " failed, "
+		<< numSkipped << " skipped in " << juce::String(seconds, 1) << " s" << std::endl;
+
+	return numFailed.load() > 0 ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Builds the command line tools on a Linux machine without a display, the way CI does.
+#
+#   JUCE_DIR=/path/to/JUCE Tools/build-linux.sh [Release|Debug] [tool...]
+#
+# JUCE 7 is expected at $JUCE_DIR, ~/JUCE by default. The Projucer is built from it
+# once, then regenerates each tool's Builds/LinuxMakefile, which is not committed,
+# and make builds it. The tools only need libcurl on top of a compiler, the Projucer
+# itself also wants the X11, freetype and alsa headers:
+#
+#   apt-get install build-essential pkg-config libcurl4-openssl-dev libasound2-dev \
+#       libfreetype-dev libfontconfig1-dev libx11-dev libxcomposite-dev libxcursor-dev \
+#       libxext-dev libxinerama-dev libxrandr-dev libxrender-dev libglu1-mesa-dev
+#
+# The binaries end up in Tools/<tool>/Builds/LinuxMakefile/build/.
+
+set -e
+
+config=${1:-Release}
+[ $# -gt 0 ] && shift
+tools=${*:-SpectrogramCLI SpectrogramBench}
+
+juce=${JUCE_DIR:-$HOME/JUCE}
+here=$(cd "$(dirname "$0")" && pwd)
+jobs=$(nproc)
+
+projucer=$juce/extras/Projucer/Builds/LinuxMakefile/build/Projucer
+if [ ! -x "$projucer" ]; then
+	make -C "$juce/extras/Projucer/Builds/LinuxMakefile" CONFIG=Release -j"$jobs"
+fi
+
+# the projects use the global module path, point it at this JUCE
+"$projucer" --set-global-search-path linux defaultJuceModulePath "$juce/modules"
+
+for tool in $tools; do
+	"$projucer" --resave "$here/$tool/$tool.jucer"
+	make -C "$here/$tool/Builds/LinuxMakefile" CONFIG="$config" -j"$jobs"
+done